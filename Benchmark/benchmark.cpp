@@ -0,0 +1,791 @@
+/**
+ * @file benchmark.cpp
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The benchmarks of the pipeline, from reading the dataset and the raw log to training the model and saving the labels.
+ *        Each benchmark runs on the bundled demo data and on the data scaled up by `--scale`, the synthetic scans are made by the scan generator.
+ *        The result is the median of the repeats, and it can be written into a JSON file to compare with another version by `--compare`.
+ *        Execute it by `mrl_bench [--filter <substring>] [--min-time <seconds>] [--repeat <n>] [--scale <n>] [--json <output>] [--compare <old json>]`.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include <cstdlib>    // included first, thus __GLIBC__ is defined before the allocation counter
+
+#include "Controller.h"
+#include "adaboost.h"
+#include "dataset.h"
+#include "logistic.h"
+#include "make_feature.h"
+#include "metric.h"
+#include "normalize.h"
+#include "file_handler.h"
+#include "log_store.h"
+#include "label_journal.h"
+#include "label_save.h"
+#include "scan_generator.h"
+#include "json.hpp"
+#include "Eigen/Eigen"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * The allocation counter. On glibc all the allocations, including Eigen's, go through malloc thus it's replaced,
+ * otherwise only the allocations of `new` are counted. The allocations of the background threads are also counted.
+ * The bytes are the requested sizes, the memory freed in the operation isn't subtracted.
+ */
+static std::atomic<std::uint64_t> alloc_count = 0;
+static std::atomic<std::uint64_t> alloc_bytes = 0;
+
+#if defined(__GLIBC__)
+extern "C" {
+void *__libc_malloc(std::size_t size);
+void *__libc_calloc(std::size_t num, std::size_t size);
+void *__libc_realloc(void *ptr, std::size_t size);
+
+void *malloc(std::size_t size) noexcept
+{
+  alloc_count.fetch_add(1, std::memory_order_relaxed);
+  alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+  return __libc_malloc(size);
+}
+
+void *calloc(std::size_t num, std::size_t size) noexcept
+{
+  alloc_count.fetch_add(1, std::memory_order_relaxed);
+  alloc_bytes.fetch_add(num * size, std::memory_order_relaxed);
+  return __libc_calloc(num, size);
+}
+
+void *realloc(void *ptr, std::size_t size) noexcept
+{
+  alloc_count.fetch_add(1, std::memory_order_relaxed);
+  alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+  return __libc_realloc(ptr, size);
+}
+}
+#else
+void *operator new(std::size_t size)
+{
+  alloc_count.fetch_add(1, std::memory_order_relaxed);
+  alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+  if (void *ptr = std::malloc(size == 0 ? 1 : size))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+#endif
+
+struct BenchOption {
+  std::string filter;    // only run the benchmarks whose "name/data" contains it
+  double min_time = 0.2;    // the seconds of a repeat at least
+  int repeat = 3;
+  int scale = 4;    // the scale of the scaled-up data
+  std::string json_path;
+  std::string compare_path;
+};
+
+struct BenchResult {
+  std::string name;
+  std::string data;
+  std::int64_t iterations;    // the iterations of a repeat
+  double ns_per_op;    // the median of the repeats
+  double min_ns_per_op;
+  double items_per_second;
+  double allocs_per_op;
+  double bytes_per_op;    // the allocated bytes
+};
+
+class BenchRunner {
+public:
+  explicit BenchRunner(const BenchOption &option)
+      : _option(option) {}
+
+  /**
+   * @brief Time the function, it's called repeatedly until a repeat takes `min_time` seconds.
+   *
+   * @param name The name of the benchmark.
+   * @param data The name of the data.
+   * @param items_per_op The items processed by a call, for the items/s.
+   * @param function The operation, it returns a value depending on the work, thus the work isn't optimized away.
+   */
+  /**
+   * @brief Whether a benchmark of the names is selected by the filter, the setup of a group is skipped if none of them is selected.
+   */
+  bool wants(const std::vector<std::string> &name_vec, const std::string &data) const
+  {
+    return std::any_of(name_vec.begin(), name_vec.end(),
+                       [&](const std::string &name) { return _option.filter.empty() || (name + '/' + data).find(_option.filter) != std::string::npos; });
+  }
+
+  template <typename Function>
+  void run(const std::string &name, const std::string &data, const double items_per_op, Function &&function)
+  {
+    if (!wants({ name }, data))
+      return;
+
+    // find the iterations taking min_time seconds, start from 1 thus the slow benchmarks are called only once here
+    std::int64_t iterations = 1;
+    while (true) {
+      const double seconds = _time(iterations, function);
+      if (seconds >= _option.min_time * 0.1) {
+        iterations = std::max<std::int64_t>(1, static_cast<std::int64_t>(std::ceil(iterations * _option.min_time / seconds)));
+        break;
+      }
+      iterations *= 10;
+    }
+
+    std::vector<double> ns_vec;
+    const std::uint64_t alloc_start = alloc_count.load(std::memory_order_relaxed);
+    const std::uint64_t bytes_start = alloc_bytes.load(std::memory_order_relaxed);
+    for (int r = 0; r < _option.repeat; ++r)
+      ns_vec.push_back(_time(iterations, function) * 1e9 / iterations);
+    const std::uint64_t alloc_num = alloc_count.load(std::memory_order_relaxed) - alloc_start;
+    const std::uint64_t byte_num = alloc_bytes.load(std::memory_order_relaxed) - bytes_start;
+
+    std::sort(ns_vec.begin(), ns_vec.end());
+    BenchResult result;
+    result.name = name;
+    result.data = data;
+    result.iterations = iterations;
+    result.ns_per_op = ns_vec[ns_vec.size() / 2];
+    result.min_ns_per_op = ns_vec.front();
+    result.items_per_second = items_per_op * 1e9 / result.ns_per_op;
+    result.allocs_per_op = static_cast<double>(alloc_num) / (static_cast<double>(iterations) * _option.repeat);
+    result.bytes_per_op = static_cast<double>(byte_num) / (static_cast<double>(iterations) * _option.repeat);
+
+    std::printf("%-28s %-12s %10lld %16.1f ns/op %16.1f items/s %10.2f allocs/op %14.0f B/op\n", name.c_str(), data.c_str(),
+                static_cast<long long>(iterations), result.ns_per_op, result.items_per_second, result.allocs_per_op, result.bytes_per_op);
+    std::fflush(stdout);
+    _result_vec.push_back(std::move(result));
+  }
+
+  const std::vector<BenchResult> &results() const { return _result_vec; }
+  double sink() const { return _sink; }
+
+private:
+  template <typename Function>
+  double _time(const std::int64_t iterations, Function &function)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    for (std::int64_t i = 0; i < iterations; ++i)
+      _sink = _sink + static_cast<double>(function());
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+private:
+  const BenchOption &_option;
+  std::vector<BenchResult> _result_vec;
+  volatile double _sink = 0;
+};
+
+/**
+ * @brief The raw log of the benchmarks, it only reuses the transformation and the frame reading of the animation controller.
+ */
+class BenchController : public AnimationController {
+public:
+  void check_update_frame() override {}
+
+  void open(const std::string &raw_path, const std::string &raw_bin_path, const int hz)
+  {
+    raw_data_path = raw_path;
+    _raw_bin_path = raw_bin_path;
+    HZ = hz;
+    transform_frame();
+  }
+
+  void close() { _raw_bin_window.close(); }
+  MappedWindow &raw_bin_window() { return _raw_bin_window; }
+  bool xydata() const { return is_xydata; }
+};
+
+/**
+ * @brief Write the frames of the generator into a raw log.
+ */
+static void write_raw_log(const std::string &raw_path, const ScanGenerator &generator, const int frame_num)
+{
+  std::ofstream outfile(raw_path, std::ios::binary | std::ios::trunc);
+  if (outfile.fail()) {
+    std::cerr << "cant open " << raw_path << '\n';
+    exit(1);
+  }
+
+  Eigen::MatrixXd raw_data;
+  std::vector<std::uint8_t> point_label;
+  std::string text;
+  for (int f = 0; f < frame_num; ++f) {
+    generator.make_frame(f, raw_data, point_label);
+    ScanGenerator::append_raw_text(raw_data, text);
+  }
+  outfile.write(text.data(), text.size());
+}
+
+/**
+ * @brief Write the demo dataset repeated `scale` times with a small noise, in the format of the demo files.
+ */
+static void write_scaled_dataset(const Eigen::MatrixXd &X, const Eigen::VectorXd &Y, const int scale, const std::string &x_path, const std::string &y_path)
+{
+  std::ofstream x_file(x_path, std::ios::trunc), y_file(y_path, std::ios::trunc);
+  if (x_file.fail() || y_file.fail()) {
+    std::cerr << "cant open " << x_path << '\n';
+    exit(1);
+  }
+
+  std::mt19937 gen(7);
+  std::normal_distribution<double> noise(1, 0.01);
+  for (int s = 0; s < scale; ++s) {
+    for (int r = 0; r < X.rows(); ++r) {
+      for (int c = 0; c < X.cols(); ++c)
+        x_file << X(r, c) * noise(gen) << (c + 1 == X.cols() ? '\n' : ' ');
+      y_file << Y(r) << '\n';
+    }
+  }
+}
+
+/**
+ * @brief Time the save of the label tool over the frame order, i.e. the writer thread's `LabelSave::write_batch` of one save,
+ *        the journal is synchronized before the stores are written. The GUI part of `LabelController::check_save_data`
+ *        (copying the labels into the table and pushing the record) isn't included, the controller needs the GUI to be constructed.
+ */
+static void bench_label_save(BenchRunner &runner, const std::string &data, const std::string &dir, const int segment_num, const bool in_order)
+{
+  const std::string name = in_order ? "label_save_in_order" : "label_save_out_of_order";
+  if (!runner.wants({ name }, data))
+    return;
+
+  constexpr int FRAME_NUM = 20000;
+
+  const std::string prefix = dir + "/save_" + data + (in_order ? "_in_order" : "_out_of_order");
+  LogStore feature_store, label_store;
+  LabelJournal journal;
+  feature_store.open(prefix + "_feature_bin.txt", prefix + "_feature_num_bin.txt", FRAME_NUM, sizeof(double));
+  label_store.open(prefix + "_label_bin.txt", prefix + "_label_num_bin.txt", FRAME_NUM, sizeof(int));
+  journal.open(prefix + "_label_bin.txt.journal");
+
+  std::vector<int> frame_order(FRAME_NUM);
+  std::iota(frame_order.begin(), frame_order.end(), 0);
+  if (!in_order)
+    std::shuffle(frame_order.begin(), frame_order.end(), std::mt19937(3));
+
+  LabelSaveRecord record{ 0, std::vector<double>(segment_num * FEATURE_NUM, 0.5), std::vector<int>(segment_num, 0) };
+  const std::vector<const LabelSaveRecord *> batch{ &record };
+
+  std::int64_t save_i = 0;
+  runner.run(name, data, 1, [&]() {
+    record.frame = frame_order[save_i++ % FRAME_NUM];
+    LabelSave::write_batch(journal, feature_store, label_store, batch);
+    return record.frame;
+  });
+}
+
+/**
+ * @brief Time the recovery of the label tool, i.e. replaying the journal into the stores as `LabelController::load` does.
+ *        The journal has a save of each frame, up to the journal size of a checkpoint, which is the largest journal left by a crash.
+ */
+static void bench_journal_replay(BenchRunner &runner, const std::string &data, const std::string &dir, const int segment_num)
+{
+  if (!runner.wants({ "journal_replay" }, data))
+    return;
+
+  constexpr int FRAME_NUM = 20000;
+
+  const std::string prefix = dir + "/replay_" + data;
+  LogStore feature_store, label_store;
+  feature_store.open(prefix + "_feature_bin.txt", prefix + "_feature_num_bin.txt", FRAME_NUM, sizeof(double));
+  label_store.open(prefix + "_label_bin.txt", prefix + "_label_num_bin.txt", FRAME_NUM, sizeof(int));
+
+  const std::string journal_path = prefix + "_label_bin.txt.journal";
+  std::filesystem::remove(journal_path);
+  int record_num = 0;
+  {
+    LabelJournal journal;
+    journal.open(journal_path);
+
+    const std::vector<double> feature(segment_num * FEATURE_NUM, 0.5);
+    const std::vector<int> label(segment_num, 0);
+    const int feature_size = static_cast<int>(feature.size() * sizeof(double));
+    const int label_size = static_cast<int>(label.size() * sizeof(int));
+    for (; record_num < FRAME_NUM && journal.bytes() + feature_size + label_size <= LabelSave::JOURNAL_CHECKPOINT_BYTES; ++record_num)
+      journal.append(record_num, feature.data(), feature_size, label.data(), label_size);
+    journal.sync();
+  }
+
+  runner.run("journal_replay", data, record_num, [&]() {
+    feature_store.clear();
+    label_store.clear();
+
+    LabelJournal journal;
+    journal.open(journal_path);
+    int last_frame = -1;
+    return LabelSave::replay(journal, feature_store, label_store, last_frame);
+  });
+}
+
+/**
+ * @brief Check the stores and the mapped window past 4 GB, then time reading the last frame of the large log.
+ *        The log is a sparse file written in the old index format (records stored in frame order), thus it takes no disk space
+ *        and the conversion of the old index to the 64-bit offsets is checked too.
+ *
+ * @return bool False if a frame past 4 GB is not read back.
+ */
+static bool bench_large_log(BenchRunner &runner, const std::string &dir)
+{
+  if (!runner.wants({ "large_log_read", "large_log_map" }, "6GB"))
+    return true;
+
+  constexpr int HOLE_FRAME_NUM = 3;
+  constexpr int HOLE_SIZE = std::numeric_limits<int>::max();
+  constexpr int FRAME_NUM = HOLE_FRAME_NUM + 1;
+  constexpr std::int64_t LAST_OFFSET = std::int64_t{ HOLE_SIZE } * HOLE_FRAME_NUM;
+
+  const std::string log_path = dir + "/large_label_bin.txt";
+  const std::string index_path = dir + "/large_label_num_bin.txt";
+  std::vector<int> record(1024);
+  std::iota(record.begin(), record.end(), 0);
+  const int record_size = static_cast<int>(record.size() * sizeof(int));
+
+  {
+    std::ofstream log_file(log_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    std::ofstream index_file(index_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    for (int frame = 0; frame < HOLE_FRAME_NUM; ++frame)
+      index_file.write(reinterpret_cast<const char *>(&HOLE_SIZE), sizeof(int));
+    index_file.write(reinterpret_cast<const char *>(&record_size), sizeof(int));
+  }
+  std::filesystem::resize_file(log_path, LAST_OFFSET);
+  {
+    std::ofstream log_file(log_path, std::ios::out | std::ios::binary | std::ios::app);
+    log_file.write(reinterpret_cast<const char *>(record.data()), record_size);
+    if (!log_file.good()) {
+      std::cerr << "cant write " << log_path << '\n';
+      return false;
+    }
+  }
+
+  const auto check_store = [&](LogStore &store, const std::int64_t offset) {
+    std::vector<int> read_record;
+    return store.offset(FRAME_NUM - 1) == offset && store.read(FRAME_NUM - 1, read_record) && read_record == record;
+  };
+  const auto check_window = [&](MappedWindow &window, const std::int64_t offset) {
+    const char *data = window.map(offset, record_size);
+    return data != nullptr && std::equal(record.begin(), record.end(), reinterpret_cast<const int *>(data));
+  };
+
+  // the old index is converted when it's opened, then a save is appended past the old record
+  bool is_ok;
+  {
+    LogStore store;
+    store.open(log_path, index_path, FRAME_NUM, sizeof(int));
+    is_ok = check_store(store, LAST_OFFSET);
+    std::reverse(record.begin(), record.end());
+    store.append(FRAME_NUM - 1, record.data(), record_size);
+    is_ok = is_ok && check_store(store, LAST_OFFSET + record_size);
+  }
+
+  LogStore store;
+  store.open(log_path, index_path, FRAME_NUM, sizeof(int));
+  MappedWindow window;
+  is_ok = is_ok && check_store(store, LAST_OFFSET + record_size) && window.open(log_path) && check_window(window, store.offset(FRAME_NUM - 1));
+  if (!is_ok) {
+    std::cerr << "the frame past 4 GB of " << log_path << " is not read back\n";
+    return false;
+  }
+
+  std::vector<int> read_record;
+  runner.run("large_log_read", "6GB", 1, [&]() {
+    store.read(FRAME_NUM - 1, read_record);
+    return read_record.back();
+  });
+  runner.run("large_log_map", "6GB", 1, [&]() {
+    window.close();
+    window.open(log_path);
+    return *reinterpret_cast<const int *>(window.map(store.offset(FRAME_NUM - 1), record_size));
+  });
+
+  return true;
+}
+
+/**
+ * @brief Make the scans of the generator, and the segments of all the scans.
+ */
+static void make_scans(const ScanGenerator &generator, const int scan_num, std::vector<Eigen::MatrixXd> &scan_vec, std::vector<Eigen::MatrixXd> &segment_vec)
+{
+  std::vector<std::uint8_t> point_label;
+  for (int f = 0; f < scan_num; ++f) {
+    scan_vec.emplace_back();
+    generator.make_frame(f * 5, scan_vec.back(), point_label);
+
+    for (auto &segment : metric::section_to_segment(scan_vec.back()))
+      segment_vec.push_back(std::move(segment));
+  }
+}
+
+/**
+ * @brief Time reading the raw log, i.e. transforming it into the binary file and reading a frame of it.
+ */
+static void bench_raw_log(BenchRunner &runner, const std::string &data, const std::string &dir, const ScanGenerator &generator, const int HZ)
+{
+  if (!runner.wants({ "transform_frame", "read_frame" }, data))
+    return;
+
+  constexpr int RAW_FRAME_NUM = 200;
+  const std::string raw_path = dir + "/raw_" + data + ".txt";
+  const std::string raw_bin_path = dir + "/raw_" + data + "_bin.txt";
+  write_raw_log(raw_path, generator, RAW_FRAME_NUM);
+
+  BenchController controller;
+  runner.run("transform_frame", data, static_cast<double>(RAW_FRAME_NUM) * HZ, [&]() {
+    controller.open(raw_path, raw_bin_path, HZ);
+    return controller.max_frame;
+  });
+
+  controller.open(raw_path, raw_bin_path, HZ);
+  Eigen::MatrixXd xy_data;
+  int frame_i = 0;
+  runner.run("read_frame", data, HZ, [&]() {
+    AnimationController::read_frame(controller.raw_bin_window(), frame_i, HZ, controller.xydata(), xy_data);
+    frame_i = (frame_i + 1) % (controller.max_frame + 1);
+    return xy_data(0, 0);
+  });
+  controller.close();
+}
+
+/**
+ * @brief Time the transformation of the scans into the segments and the features.
+ */
+static void bench_features(BenchRunner &runner, const std::string &data, const ScanGenerator &generator, const int HZ)
+{
+  if (!runner.wants({ "rtheta_to_xy", "section_to_segment", "section_to_feature", "cal_point", "cal_std", "cal_width", "cal_cr", "cal_linearity",
+                      "segment_to_feature" },
+                    data))
+    return;
+
+  constexpr int SCAN_NUM = 32;
+  std::vector<Eigen::MatrixXd> scan_vec, rtheta_vec, segment_vec;
+  make_scans(generator, SCAN_NUM, scan_vec, segment_vec);
+  for (const auto &scan : scan_vec) {
+    Eigen::MatrixXd rtheta(HZ, 2);
+    for (int i = 0; i < HZ; ++i) {
+      rtheta(i, 0) = 360.0 * i / HZ;
+      rtheta(i, 1) = scan.row(i).norm();
+    }
+    rtheta_vec.push_back(std::move(rtheta));
+  }
+
+  int scan_i = 0;
+  Eigen::MatrixXd rtheta_buf;
+  runner.run("rtheta_to_xy", data, HZ, [&]() {
+    rtheta_buf = rtheta_vec[scan_i++ % SCAN_NUM];    // the copy is in the time, it's small compared with the transformation
+    metric::rtheta_to_xy(rtheta_buf, HZ);
+    return rtheta_buf(0, 0);
+  });
+  runner.run("section_to_segment", data, HZ, [&]() { return metric::section_to_segment(scan_vec[scan_i++ % SCAN_NUM]).size(); });
+  runner.run("section_to_feature", data, HZ, [&]() { return MakeFeatures::section_to_feature(scan_vec[scan_i++ % SCAN_NUM]).first.rows(); });
+
+  // each call goes through all the segments of the scans
+  const double segment_num = static_cast<double>(segment_vec.size());
+  runner.run("cal_point", data, segment_num, [&]() {
+    double sum = 0;
+    for (const auto &segment : segment_vec)
+      sum += MakeFeatures::cal_point(segment);
+    return sum;
+  });
+  runner.run("cal_std", data, segment_num, [&]() {
+    double sum = 0;
+    for (const auto &segment : segment_vec)
+      sum += MakeFeatures::cal_std(segment);
+    return sum;
+  });
+  runner.run("cal_width", data, segment_num, [&]() {
+    double sum = 0;
+    for (const auto &segment : segment_vec)
+      sum += MakeFeatures::cal_width(segment);
+    return sum;
+  });
+  runner.run("cal_cr", data, segment_num, [&]() {
+    double sum = 0;
+    for (const auto &segment : segment_vec)
+      sum += std::get<0>(MakeFeatures::cal_cr(segment));
+    return sum;
+  });
+  runner.run("cal_linearity", data, segment_num, [&]() {
+    double sum = 0;
+    for (const auto &segment : segment_vec)
+      sum += std::get<3>(MakeFeatures::cal_linearity(segment));
+    return sum;
+  });
+  runner.run("segment_to_feature", data, segment_num, [&]() { return MakeFeatures::segment_to_feature(segment_vec).rows(); });
+}
+
+// the benchmarks reading the dataset files, the scaled dataset is written only if one of them is selected
+static const std::vector<std::string> DATASET_BENCH_NAMES = { "readDataSet", "readLabel" };
+static const std::vector<std::string> MODEL_BENCH_NAMES = { "Normalizer::transform", "logistic::fit", "logistic::fit sgd", "Adaboost::fit", "Adaboost::predict" };
+static const std::vector<std::string> SUBSET_BENCH_NAMES = { "fold copy", "fold view", "bootstrap copy", "bootstrap view", "logistic::fit bootstrap copy",
+                                                             "logistic::fit bootstrap view" };
+
+/**
+ * @brief Time the normalization, the training and the prediction of the model.
+ */
+static void bench_model(BenchRunner &runner, const std::string &data, const std::string &x_path, const std::string &y_path, const int row_num)
+{
+  if (!runner.wants(MODEL_BENCH_NAMES, data))
+    return;
+
+  const Eigen::MatrixXd raw_X = LoadMatrix::readDataSet(x_path, row_num, FEATURE_NUM);
+  const Eigen::VectorXd Y = LoadMatrix::readLabel(y_path, row_num);
+  Normalizer normalizer;
+  normalizer.fit(raw_X);
+  runner.run("Normalizer::transform", data, row_num, [&]() { return normalizer.transform(raw_X)(0, 0); });
+
+  const Eigen::MatrixXd X = normalizer.transform(raw_X);
+  const Eigen::VectorXd weight = Eigen::VectorXd::Ones(row_num) / row_num;
+  logistic learner;
+  runner.run("logistic::fit", data, row_num, [&]() { return std::get<1>(learner.fit(X, Y, weight, 1000)); });
+
+  // the mini-batch training with the early stopping, at most 50 epochs
+  logistic sgd_learner;
+  sgd_learner.sgd.batch_size = 256;
+  runner.run("logistic::fit sgd", data, row_num, [&]() { return std::get<1>(sgd_learner.fit(X, Y, weight, 50)); });
+
+  if (!runner.wants({ "Adaboost::fit", "Adaboost::predict" }, data))
+    return;
+
+  // the rounds print the progress, thus the output is discarded
+  constexpr int ROUND_NUM = 5;
+  Adaboost<logistic> model;
+  std::stringstream discard;
+  std::streambuf *cout_buf = std::cout.rdbuf(discard.rdbuf());
+  runner.run("Adaboost::fit", data, row_num, [&]() {
+    model = Adaboost<logistic>(ROUND_NUM);
+    model.fit(X, Y);
+    discard.str("");
+    return model.M;
+  });
+  if (model.M == 0) {
+    model = Adaboost<logistic>(ROUND_NUM);    // the fit was filtered out, the prediction still needs a model
+    model.fit(X, Y);
+  }
+  std::cout.rdbuf(cout_buf);
+  runner.run("Adaboost::predict", data, row_num, [&]() { return model.predict(X).sum(); });
+}
+
+/**
+ * @brief Time the subsets of the cross-validation and the bagging, a copy of the rows against a view of them.
+ */
+static void bench_subsets(BenchRunner &runner, const std::string &data, const std::string &x_path, const std::string &y_path, const int row_num)
+{
+  if (!runner.wants(SUBSET_BENCH_NAMES, data))
+    return;
+
+  const Eigen::MatrixXd raw_X = LoadMatrix::readDataSet(x_path, row_num, FEATURE_NUM);
+  const Eigen::VectorXd Y = LoadMatrix::readLabel(y_path, row_num);
+  Normalizer normalizer;
+  normalizer.fit(raw_X);
+  const Eigen::MatrixXd X = normalizer.transform(raw_X);
+  const Eigen::VectorXd weight = Eigen::VectorXd::Ones(row_num) / row_num;
+
+  constexpr int FOLD_NUM = 5;
+  const Dataset dataset(X, Y);
+  runner.run("fold copy", data, row_num, [&]() {
+    const auto [train, valid] = dataset.fold(0, FOLD_NUM);
+    const Eigen::MatrixXd train_X = train.gather_features(), valid_X = valid.gather_features();
+    return train_X(0, 0) + valid_X(0, 0) + train.gather_labels().sum() + valid.gather_labels().sum();
+  });
+  runner.run("fold view", data, row_num, [&]() {
+    const auto [train, valid] = dataset.fold(0, FOLD_NUM);
+    return train.row(0)(0) + valid.row(0)(0);
+  });
+  runner.run("bootstrap copy", data, row_num, [&]() {
+    const Dataset sample = dataset.bootstrap(row_num, 0);
+    return sample.gather_features()(0, 0) + sample.gather_labels().sum();
+  });
+  runner.run("bootstrap view", data, row_num, [&]() { return dataset.bootstrap(row_num, 0).row(0)(0); });
+
+  logistic learner;
+  const Dataset sample = dataset.bootstrap(row_num, 0);
+  const Eigen::MatrixXd sample_X = sample.gather_features();
+  const Eigen::VectorXd sample_Y = sample.gather_labels();
+  runner.run("logistic::fit bootstrap copy", data, row_num, [&]() { return std::get<1>(learner.fit(sample_X, sample_Y, weight, 300)); });
+  runner.run("logistic::fit bootstrap view", data, row_num, [&]() { return std::get<1>(learner.fit(sample, weight, 300)); });
+}
+
+/**
+ * @brief Run all the benchmarks on a dataset and a scan size, each group checks the filter before its setup.
+ *
+ * @param runner The runner.
+ * @param data The name of the data.
+ * @param dir The directory of the temporary files.
+ * @param x_path The feature file, in the format of the demo data.
+ * @param y_path The label file, in the format of the demo data.
+ * @param row_num The rows of the feature file.
+ * @param HZ The numbers of the points in a scan.
+ */
+static void bench_all(BenchRunner &runner, const std::string &data, const std::string &dir, const std::string &x_path, const std::string &y_path,
+                      const int row_num, const int HZ)
+{
+  // reading the dataset
+  runner.run("readDataSet", data, row_num, [&]() { return LoadMatrix::readDataSet(x_path, row_num, FEATURE_NUM).rows(); });
+  runner.run("readLabel", data, row_num, [&]() { return LoadMatrix::readLabel(y_path, row_num).size(); });
+
+  ScanScene scene;
+  scene.HZ = HZ;
+  const ScanGenerator generator(scene);
+  bench_raw_log(runner, data, dir, generator, HZ);
+  bench_features(runner, data, generator, HZ);
+  bench_model(runner, data, x_path, y_path, row_num);
+  bench_subsets(runner, data, x_path, y_path, row_num);
+
+  // saving the labels, a frame has about the segments of a scan
+  if (!runner.wants({ "label_save_in_order", "label_save_out_of_order", "journal_replay" }, data))
+    return;
+
+  constexpr int SCAN_NUM = 32;
+  std::vector<Eigen::MatrixXd> scan_vec, segment_vec;
+  make_scans(generator, SCAN_NUM, scan_vec, segment_vec);
+  const int save_segment_num = static_cast<int>(segment_vec.size() / SCAN_NUM);
+  bench_label_save(runner, data, dir, save_segment_num, true);
+  bench_label_save(runner, data, dir, save_segment_num, false);
+  bench_journal_replay(runner, data, dir, save_segment_num);
+}
+
+/**
+ * @brief Write the results and the context of the run into the JSON file.
+ */
+static void write_json(const std::string &json_path, const BenchOption &option, const std::vector<BenchResult> &result_vec)
+{
+  std::ofstream outfile(json_path, std::ios::trunc);
+  if (outfile.fail()) {
+    std::cerr << "cant open " << json_path << '\n';
+    exit(1);
+  }
+
+  nlohmann::ordered_json root;
+  char date[32];
+  const std::time_t now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+  root["context"] = { { "date", date },
+                      { "scale", option.scale },
+                      { "min_time", option.min_time },
+                      { "repeat", option.repeat },
+                      { "threads", std::thread::hardware_concurrency() },
+#ifdef NDEBUG
+                      { "build", "release" } };
+#else
+                      { "build", "debug" } };
+#endif
+
+  root["benchmarks"] = nlohmann::ordered_json::array();
+  for (const BenchResult &result : result_vec) {
+    root["benchmarks"].push_back({ { "name", result.name },
+                                   { "data", result.data },
+                                   { "iterations", result.iterations },
+                                   { "ns_per_op", result.ns_per_op },
+                                   { "min_ns_per_op", result.min_ns_per_op },
+                                   { "items_per_second", result.items_per_second },
+                                   { "allocs_per_op", result.allocs_per_op },
+                                   { "bytes_per_op", result.bytes_per_op } });
+  }
+
+  outfile << root.dump(2) << '\n';
+}
+
+/**
+ * @brief Print the change of each benchmark against the JSON file of another run.
+ */
+static void compare_json(const std::string &compare_path, const std::vector<BenchResult> &result_vec)
+{
+  std::ifstream infile(compare_path);
+  if (infile.fail()) {
+    std::cerr << "cant open " << compare_path << '\n';
+    exit(1);
+  }
+
+  const nlohmann::json old_root = nlohmann::json::parse(infile);
+  std::printf("\n%-28s %-12s %16s %16s %10s\n", "benchmark", "data", "old ns/op", "new ns/op", "change");
+  for (const BenchResult &result : result_vec) {
+    for (const auto &old_result : old_root["benchmarks"]) {
+      if (old_result["name"] == result.name && old_result["data"] == result.data) {
+        const double old_ns = old_result["ns_per_op"];
+        std::printf("%-28s %-12s %16.1f %16.1f %+9.1f%%\n", result.name.c_str(), result.data.c_str(), old_ns, result.ns_per_op,
+                    (result.ns_per_op / old_ns - 1) * 100);
+      }
+    }
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  BenchOption option;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (i + 1 >= argc) {
+      std::cerr << "missing the value of " << arg << '\n';
+      return 1;
+    }
+
+    if (arg == "--filter")
+      option.filter = argv[++i];
+    else if (arg == "--min-time")
+      option.min_time = std::stod(argv[++i]);
+    else if (arg == "--repeat")
+      option.repeat = std::max(1, std::stoi(argv[++i]));
+    else if (arg == "--scale")
+      option.scale = std::max(1, std::stoi(argv[++i]));
+    else if (arg == "--json")
+      option.json_path = argv[++i];
+    else if (arg == "--compare")
+      option.compare_path = argv[++i];
+    else {
+      std::cerr << "usage: " << argv[0] << " [--filter <substring>] [--min-time <seconds>] [--repeat <n>] [--scale <n>] [--json <output>] [--compare <old json>]\n";
+      return 1;
+    }
+  }
+
+  const std::string demo_dir = FileHandler::get_MRL_project_root() + "/dataset/demo_data";
+  const std::string bench_dir = (std::filesystem::temp_directory_path() / "mrl_bench").string();
+  std::filesystem::remove_all(bench_dir);
+  std::filesystem::create_directories(bench_dir);
+
+  constexpr int DEMO_ROW_NUM = 18268;    // the rows of default_train_x.txt
+  constexpr int DEMO_HZ = 360;
+  const std::string demo_x_path = demo_dir + "/default_train_x.txt";
+  const std::string demo_y_path = demo_dir + "/default_train_y.txt";
+
+  const std::string scaled_data = "x" + std::to_string(option.scale);
+  const std::string scaled_x_path = bench_dir + "/" + scaled_data + "_x.txt";
+  const std::string scaled_y_path = bench_dir + "/" + scaled_data + "_y.txt";
+  BenchRunner runner(option);
+  if (runner.wants(DATASET_BENCH_NAMES, scaled_data) || runner.wants(MODEL_BENCH_NAMES, scaled_data) || runner.wants(SUBSET_BENCH_NAMES, scaled_data))
+    write_scaled_dataset(LoadMatrix::readDataSet(demo_x_path, DEMO_ROW_NUM, FEATURE_NUM), LoadMatrix::readLabel(demo_y_path, DEMO_ROW_NUM), option.scale,
+                         scaled_x_path, scaled_y_path);
+
+  std::printf("%-28s %-12s %10s %22s %24s %20s %19s\n", "benchmark", "data", "iterations", "time", "throughput", "allocations", "memory");
+  bench_all(runner, "demo", bench_dir, demo_x_path, demo_y_path, DEMO_ROW_NUM, DEMO_HZ);
+  bench_all(runner, scaled_data, bench_dir, scaled_x_path, scaled_y_path, DEMO_ROW_NUM * option.scale, DEMO_HZ * option.scale);
+  const bool large_log_ok = bench_large_log(runner, bench_dir);
+
+  if (!option.json_path.empty())
+    write_json(option.json_path, option, runner.results());
+  if (!option.compare_path.empty())
+    compare_json(option.compare_path, runner.results());
+
+  std::filesystem::remove_all(bench_dir);
+  return large_log_ok ? 0 : 1;
+}
@@ -10,205 +10,91 @@
  */
 
 #include "LabelController.h"
-#include "make_feature.h"
 #include "file_handler.h"
-#include "json.hpp"
+#include "profiler.h"
 
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <filesystem>
+#include <algorithm>
 
 /**
- * @brief Write the feature binary file. (matrix -> binary file)
- *
- * @param feature_index the index would be written
- * @param feature_matrix  the matrix would be written to the file.
+ * @brief Synchronize the stores to the disk, then the records in the journal are no longer needed.
  */
-void LabelController::_write_bin_feature_data(const int feature_index, const Eigen::MatrixXd &feature_matrix)
+void LabelController::_checkpoint()
 {
-  _feature_bin_file.seekp(feature_index, std::ios::beg);
-  for (const auto &row : feature_matrix.rowwise()) {
-    for (const double feature : row)
-      _feature_bin_file.write(reinterpret_cast<const char *>(&feature), sizeof(double));
-  }
-  _feature_bin_file.flush();
+  LabelSave::checkpoint(_journal, _feature_store, _label_store);
 }
 
 /**
- * @brief Record the numbers of features.
+ * @brief Write a batch of the saves to the journal and the stores, it's called in the writer thread.
  *
- * @param nums
+ * @param batch The saves would be written, at most one per frame.
  */
-void LabelController::_write_bin_feature_num_data(const int nums)
+void LabelController::_write_batch(const std::vector<const LabelSaveRecord *> &batch)
 {
-  _feature_num_bin_file.seekp(frame * sizeof(double), std::ios::beg);
-  _feature_num_bin_file.write(reinterpret_cast<const char *>(&nums), sizeof(double));
-  _feature_num_bin_file.flush();
+  ScopedProfile profile(ProfileStage::label_save);
+  LabelSave::write_batch(_journal, _feature_store, _label_store, batch);
 }
 
 /**
- * @brief Write the label binary file. (label -> binary file)
+ * @brief Find the first frame after the current frame which has not been labeled.
  *
- * @param label_index the index would be written
- * @param segment_label the label of the section in that frame
+ * @return int The frame, -1 if all the frames after the current frame are labeled.
  */
-void LabelController::_write_bin_label_data(const int label_index, const std::vector<int> &segment_label)
+int LabelController::next_unlabeled_frame() const
 {
-  _label_bin_file.seekp(label_index, std::ios::beg);
-  for (const int label : segment_label)
-    _label_bin_file.write(reinterpret_cast<const char *>(&label), sizeof(int));
-
-  _label_bin_file.flush();
+  return _label_table.labeled_frames().next_unset(frame + 1);
 }
 
 /**
- * @brief Record the numbers of labels
+ * @brief The memory used by the labels of all frames, one bit per segment and one bit per frame.
  *
- * @param nums
+ * @return std::size_t The bytes.
  */
-void LabelController::_write_bin_label_num_data(const int nums)
+std::size_t LabelController::label_memory_bytes() const
 {
-  _label_num_bin_file.seekp(frame * sizeof(int), std::ios::beg);
-  _label_num_bin_file.write(reinterpret_cast<const char *>(&nums), sizeof(int));
-  _label_num_bin_file.flush();
-}
-
-/**
- * @brief Output the feature of all segments to normal txt file
- */
-void LabelController::output_feature_data()
-{
-  auto bk_p = _feature_bin_file.tellg();    // record the pointer position.
-
-  // open the file would be written
-  std::ofstream feature_outfile(feature_output_path, std::ios::out | std::ios::trunc);
-  if (feature_outfile.fail()) {
-    std::cerr << "Cannot open file" << feature_output_path << '\n';
-    std::cin.get();
-    return;
-  }
-
-  // reset the pointer of binary file to the beginning.
-  _feature_bin_file.seekg(0, std::ios::beg);
-  double buf[FEATURE_NUM];    // one line of feature.
-  // read and write the feature line by line.
-  while (_feature_bin_file.read(reinterpret_cast<char *>(buf), FEATURE_NUM * sizeof(double))) {
-    for (int i{}; i < FEATURE_NUM; ++i)
-      feature_outfile << buf[i] << " \n"[i == FEATURE_NUM - 1];
-  }
-
-  // set the pointer to the original place
-  _feature_bin_file.seekg(bk_p, std::ios::beg);
-  // clear the file flag
-  _feature_bin_file.clear();
+  return _label_table.bytes();
 }
 
 /**
- * @brief Output the label of all segments into json file
+ * @brief Start exporting the feature file and the label file in the background, the labels are copied thus the labeling can go on.
+ *
+ * @param type The files would be exported.
  */
-void LabelController::output_json_label_data()
+void LabelController::start_export(const LabelExportType type)
 {
-  using json = nlohmann::json;
-  using ordered_json = nlohmann::ordered_json;
-
-  ordered_json label_data;
-  label_data["frames"] = ordered_json::array();
-
-  auto bk_p = _label_bin_file.tellg();    // record the pointer position.
-
-  for (int i = 0; i < max_frame; ++i) {
-    if (label_size_vec[i] != 0) {
-      const std::vector<Eigen::MatrixXd> &one_frame_segment_vec = total_frame_segment_vec[i];    // the i-th frame
-      std::vector<int> one_frame_segment_label(one_frame_segment_vec.size());
-
-      ordered_json one_frame_json = ordered_json::object();
-      ordered_json segments_json = ordered_json::array();
-
-      // read the label of all segment in the frame
-      _label_bin_file.seekg(label_index_vec[i], std::ios::beg);
-      _label_bin_file.read(reinterpret_cast<char *>(one_frame_segment_label.data()), label_size_vec[i]);
-
-      // iterate through all the segment in the frame
-      for (int j = 0; j < one_frame_segment_vec.size(); ++j) {
-        const Eigen::MatrixXd &segment = one_frame_segment_vec[j];    // the j-th segment in the frame
-        int segment_size = segment.rows();
-
-        ordered_json points_json = ordered_json::object();
-        points_json["x"] = ordered_json::array();
-        points_json["y"] = ordered_json::array();
-
-        // output the x and y and the corresponding label of the segment
-        for (int k = 0; k < segment_size; ++k) {
-          points_json["x"].push_back(segment(k, 0));
-          points_json["y"].push_back(segment(k, 1));
-        }
-
-        segments_json.push_back(ordered_json::object({ { "segment_index", j }, { "label", one_frame_segment_label[j] }, { "points", points_json } }));
-      }
-
-      one_frame_json["frame_index"] = i;
-      one_frame_json["segments"] = segments_json;
-      label_data["frames"].push_back(one_frame_json);
-    }
-  }
-
-  // open the file would be written
-  std::ofstream label_outfile(label_output_path, std::ios::out | std::ios::trunc);
-  if (label_outfile.fail()) {
-    std::cerr << "Cannot open file" << label_output_path << '\n';
-    std::cin.get();
+  if (_exporter.running())
     return;
-  }
 
-  label_outfile << label_data.dump(2);
-
-  // set the pointer to the original place
-  _label_bin_file.seekg(bk_p, std::ios::beg);
-  // clear the file flag
-  _label_bin_file.clear();
+  // the features are only in the stores, wait for the saves not written yet.
+  _writer.flush();
+
+  LabelExportJob job;
+  job.type = type;
+  job.feature_output_path = feature_output_path;
+  job.label_output_path = label_output_path;
+  job.npy_output_prefix = (std::filesystem::path(label_output_path).parent_path() / std::filesystem::path(label_output_path).stem()).string();
+  job.raw_bin_path = _frame_store->raw_bin_path();
+  job.HZ = HZ;
+  job.is_xydata = is_xydata;
+  job.label_table = _label_table;
+
+  const FrameBitmap &labeled_frames = _label_table.labeled_frames();
+  job.frame_vec.reserve(labeled_frames.count());
+  for (int i = labeled_frames.next_set(0); i != -1; i = labeled_frames.next_set(i + 1))
+    job.frame_vec.push_back(i);
+
+  _exporter.start(std::move(job), _feature_store);
 }
 
 /**
- * @brief Output the label of all segments to normal txt file
+ * @brief Stop the export, the output files are not changed.
  */
-void LabelController::output_xy_label_data()
+void LabelController::cancel_export()
 {
-  // open the file would be written
-  std::ofstream label_outfile(label_output_path, std::ios::out | std::ios::trunc);
-  if (label_outfile.fail()) {
-    std::cerr << "Cannot open file" << label_output_path << '\n';
-    std::cin.get();
-    return;
-  }
-
-  auto bk_p = _label_bin_file.tellg();    // record the pointer position.
-
-  for (int i = 0; i < max_frame; ++i) {
-    if (label_size_vec[i] != 0) {
-      const std::vector<Eigen::MatrixXd> &one_frame_segment_vec = total_frame_segment_vec[i];    // the i-th frame
-      std::vector<int> one_frame_segment_label(one_frame_segment_vec.size());
-
-      // read the label of all segment in the frame
-      _label_bin_file.seekg(label_index_vec[i], std::ios::beg);
-      _label_bin_file.read(reinterpret_cast<char *>(one_frame_segment_label.data()), label_size_vec[i]);
-
-      // iterate through all the segment in the frame
-      for (int j = 0; j < one_frame_segment_vec.size(); ++j) {
-        const Eigen::MatrixXd &segment = one_frame_segment_vec[j];    // the j-th segment in the frame
-        int segment_size = segment.rows();
-
-        // output the x and y and the corresponding label of the segment
-        for (int k = 0; k < segment_size; ++k)
-          label_outfile << segment(k, 0) << ' ' << segment(k, 1) << ' ' << one_frame_segment_label[j] << '\n';
-      }
-    }
-  }
-
-  // set the pointer to the original place
-  _label_bin_file.seekg(bk_p, std::ios::beg);
-  // clear the file flag
-  _label_bin_file.clear();
+  _exporter.cancel();
 }
 
 /**
@@ -218,30 +104,13 @@ void LabelController::check_clean_data()
 {
   // clean data
   if (clean_data) {
-    // clean feature binary file and feature vector
-    _feature_bin_file.seekg(0, std::ios::beg);
-    _feature_bin_file.seekp(0, std::ios::beg);
-    std::filesystem::resize_file(_feature_bin_path, 0);
-    std::fill(feature_size_vec.begin(), feature_size_vec.end(), 0);
-    std::fill(feature_index_vec.begin(), feature_index_vec.end(), 0);
-
-    // clean label binary file and label vector
-    _label_bin_file.seekg(0, std::ios::beg);
-    _label_bin_file.seekp(0, std::ios::beg);
-    std::filesystem::resize_file(_label_bin_path, 0);
-    std::fill(label_size_vec.begin(), label_size_vec.end(), 0);
-    std::fill(label_index_vec.begin(), label_index_vec.end(), 0);
-    std::fill(total_frame_segment_vec.begin(), total_frame_segment_vec.end(), std::vector<Eigen::MatrixXd>());
-
-    // clean label number binary file
-    _label_num_bin_file.seekg(0, std::ios::beg);
-    _label_num_bin_file.seekp(0, std::ios::beg);
-    std::filesystem::resize_file(_label_num_bin_path, 0);
-
-    // clean feature number binary file
-    _feature_num_bin_file.seekg(0, std::ios::beg);
-    _feature_num_bin_file.seekp(0, std::ios::beg);
-    std::filesystem::resize_file(_feature_num_bin_path, 0);
+    // clean the feature and label binary file and their index file, drop the journal first, or the old saves would be replayed.
+    _exporter.cancel();
+    _writer.flush();
+    _journal.truncate();
+    _feature_store.clear();
+    _label_store.clear();
+    _label_table.clear();
 
     // clean the output file if it exist
     if (std::filesystem::exists(feature_output_path)) std::filesystem::resize_file(feature_output_path, 0);
@@ -273,19 +142,15 @@ void LabelController::check_load_data()
   // load data
   if (load_data) {
     load_data = false;
-    transform_frame();
+    _exporter.cancel();
+    _writer.flush();
+    if (!try_transform_frame())
+      return;
 
     // resize the information vector
-    label_size_vec.resize(max_frame);
-    label_size_vec.shrink_to_fit();
-    label_index_vec.resize(max_frame);
-    label_index_vec.shrink_to_fit();
-    feature_size_vec.resize(max_frame);
-    feature_size_vec.shrink_to_fit();
-    feature_index_vec.resize(max_frame);
-    feature_index_vec.shrink_to_fit();
-    total_frame_segment_vec.resize(max_frame);
-    total_frame_segment_vec.shrink_to_fit();
+    _feature_store.resize(max_frame);
+    _label_store.resize(max_frame);
+    _label_table.resize(max_frame);
   }
 }
 
@@ -299,21 +164,15 @@ void LabelController::check_update_frame()
   if (update_frame) {
     update_frame = false;
 
-    // read the new frame into the xy_data matrix
-    read_frame();
-
-    // transform the matrix into feature.
-    std::tie(feature_matrix, segment_vec) = MakeFeatures::section_to_feature(xy_data);
+    // read the new frame with its segments and features, the Simulation window may have segmented it.
+    read_frame_data();
+    segment_grid.build(segment_vec);
+    render_buffer.invalidate();
 
-    segment_label.clear();
+    // if it had been labeled, update the information vector.
+    _label_table.get(frame, segment_label);
     segment_label.resize(segment_vec.size());
     segment_label.shrink_to_fit();
-
-    // if it had been labeled, update the information vector.
-    if (label_size_vec[frame] != 0) {
-      _label_bin_file.seekg(label_index_vec[frame], std::ios::beg);
-      _label_bin_file.read(reinterpret_cast<char *>(segment_label.data()), label_size_vec[frame]);
-    }
   }
 }
 
@@ -330,109 +189,20 @@ void LabelController::check_save_data()
     save_label = false;
 
     // have bot been written
-    const bool have_not_been_written = (label_size_vec[frame] == 0);
-    if (have_not_been_written)
-      ++writed_frame_numbers;
-
-    // set the size of the frame
-    feature_size_vec[frame] = feature_matrix.size() * sizeof(double);
-    label_size_vec[frame] = segment_vec.size() * sizeof(int);
-    total_frame_segment_vec[frame] = segment_vec;
-
-    int feature_index = 0, label_index = 0;
-    // calculate the index of this feature in the binary file
-    for (int sec_i = 0; sec_i < frame; ++sec_i) {
-      feature_index += feature_size_vec[sec_i];    // if the frame didn't be writed, the size will be zero
-      label_index += label_size_vec[sec_i];    // calculate the index of the label in the binary file
-    }
+    _label_table.set(frame, segment_label.data(), segment_label.size());
 
-    feature_index_vec[frame] = feature_index;    // It means the nth frame will been writed at `feature_index`
-    label_index_vec[frame] = label_index;    // It means the nth label will been writed at `label_index`
-
-    // upload the max frame has been writed
-    if (frame > writed_max_frame)
-      writed_max_frame = frame;
-
-    // if it's insert, not append, then move all the data after this frame
-    /*                           | 1. origin       2. move the data        3. push the data        4. move back the old data
-     *   _______                 |                                                                   _______
-     *  |___C___|                |   _______   =>            (tmp file) =>   _______            =>  |___C___|
-     *  |___B___| <- insert this |  |___C___|       _______   _______       |___B___| _______       |___B___|
-     *  |___A___|                |  |___A___|      |___A___| |___C___|      |___A___||___C___|      |___A___|
-     */
-    if (frame < writed_max_frame && have_not_been_written) {
-      std::fstream buf_feature_file(_buf_feature_path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
-      if (buf_feature_file.fail()) {
-        std::cerr << "Cannot open file" << _buf_feature_path << '\n';
-        std::cin.get();
-        exit(1);
-      }
-
-      std::fstream buf_label_file(_buf_label_path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
-      if (buf_label_file.fail()) {
-        std::cerr << "Cannot open file" << _buf_label_path << '\n';
-        std::cin.get();
-        exit(1);
-      }
-
-      std::vector<double> section_feature_buf;
-      std::vector<int> section_label_buf;
-
-      // copy all the data after this frame and move it
-      _feature_bin_file.seekg(feature_index_vec[frame], std::ios::beg);    // copy from the position will begin written
-      _label_bin_file.seekg(label_index_vec[frame], std::ios::beg);
-
-      for (int sec_i = frame + 1; sec_i <= writed_max_frame; ++sec_i) {
-        if (feature_size_vec[sec_i] != 0) {
-          // copy the section(one frame) data
-          section_feature_buf.resize(feature_size_vec[sec_i] / sizeof(double));
-          section_feature_buf.shrink_to_fit();
-          _feature_bin_file.read(reinterpret_cast<char *>(section_feature_buf.data()), feature_size_vec[sec_i]);    // copy
-          buf_feature_file.write(reinterpret_cast<char *>(section_feature_buf.data()), feature_size_vec[sec_i]);    // and write
-
-          section_label_buf.resize(label_size_vec[sec_i] / sizeof(int));
-          section_label_buf.shrink_to_fit();
-          _label_bin_file.read(reinterpret_cast<char *>(section_label_buf.data()), label_size_vec[sec_i]);    // copy
-          buf_label_file.write(reinterpret_cast<char *>(section_label_buf.data()), label_size_vec[sec_i]);    // and write
-
-          feature_index_vec[sec_i] += feature_size_vec[frame];    // add the offset of the data we will insert
-          label_index_vec[sec_i] += label_size_vec[frame];    // add the offset of the data we will insert
-        }
-      }
-
-      buf_feature_file.flush();
-      buf_label_file.flush();
-      buf_feature_file.seekg(0, std::ios::beg);
-      buf_label_file.seekg(0, std::ios::beg);
-
-      _write_bin_feature_data(feature_index, feature_matrix);
-      _write_bin_label_data(label_index, segment_label);
-
-      for (int sec_i = frame + 1; sec_i <= writed_max_frame; ++sec_i) {
-        if (feature_size_vec[sec_i] != 0) {
-          section_feature_buf.resize(feature_size_vec[sec_i] / sizeof(double));
-          section_feature_buf.shrink_to_fit();
-          buf_feature_file.read(reinterpret_cast<char *>(section_feature_buf.data()), feature_size_vec[sec_i]);    // copy
-          _feature_bin_file.write(reinterpret_cast<char *>(section_feature_buf.data()), feature_size_vec[sec_i]);    // and write
-
-          section_label_buf.resize(label_size_vec[sec_i] / sizeof(int));
-          section_label_buf.shrink_to_fit();
-          buf_label_file.read(reinterpret_cast<char *>(section_label_buf.data()), label_size_vec[sec_i]);    // copy
-          _label_bin_file.write(reinterpret_cast<char *>(section_label_buf.data()), label_size_vec[sec_i]);    // and write
-        }
-      }
-
-      _feature_bin_file.flush();
-      _label_bin_file.flush();
-    }
-    else {
-      // directly append the data
-      _write_bin_feature_data(feature_index, feature_matrix);
-      _write_bin_label_data(label_index, segment_label);
-    }
+    // upload the written information from the labeled frame bitmap
+    writed_frame_numbers = _label_table.labeled_frames().count();
+    writed_max_frame = _label_table.labeled_frames().last_set();
 
-    _write_bin_label_num_data(segment_vec.size() * sizeof(int));
-    _write_bin_feature_num_data(feature_matrix.size() * sizeof(double));
+    // hand an immutable copy of the save to the writer thread, the rendering won't wait for the disk.
+    auto record = std::make_unique<LabelSaveRecord>();
+    record->frame = frame;
+    record->feature.resize(feature_matrix.size());
+    Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(record->feature.data(), feature_matrix.rows(), feature_matrix.cols()) = feature_matrix;    // the features are stored row by row
+    record->label = segment_label;
+
+    _writer.push(std::move(record));
   }
 }
 
@@ -447,8 +217,6 @@ LabelController::LabelController() : AnimationController()
   clean_data = false;
   load_data = false;
 
-  current_save_time = std::chrono::system_clock::now();
-
   label_mouse_area = static_cast<float>(0.05);
 
   _tool_data_path = FileHandler::get_MRL_project_root() + "/dataset/binary_data/MesToolLabelController.dat";
@@ -513,8 +281,6 @@ LabelController::LabelController() : AnimationController()
     std::getline(_tool_data_file, _feature_num_bin_path);
     std::getline(_tool_data_file, _label_bin_path);
     std::getline(_tool_data_file, _label_num_bin_path);
-    _buf_feature_path = FileHandler::get_MRL_project_root() + "/dataset/binary_data/tmp_feature_buffer_data";
-    _buf_label_path = FileHandler::get_MRL_project_root() + "/dataset/binary_data/tmp_lable_buffer_data";
 
     std::string line;
     std::getline(_tool_data_file, line);
@@ -530,82 +296,60 @@ LabelController::LabelController() : AnimationController()
     std::getline(_tool_data_file, line);
     writed_frame_numbers = std::stoi(line);
   }
+}
 
-  if (!std::filesystem::exists(_feature_bin_path)) std::ofstream create_file(_feature_bin_path);    // just for creating file.
-  if (!std::filesystem::exists(_feature_num_bin_path)) std::ofstream create_file(_feature_num_bin_path);    // just for creating file.
-  if (!std::filesystem::exists(_label_bin_path)) std::ofstream create_file(_label_bin_path);    // just for creating file.
-  if (!std::filesystem::exists(_label_num_bin_path)) std::ofstream create_file(_label_num_bin_path);    // just for creating file.
+/**
+ * @brief Transform the raw data, open the stores and rebuild the label table from them, it runs in the task pool by `start_load()`.
+ *
+ * @throw std::runtime_error The raw data, the stores or the journal can't be opened.
+ */
+void LabelController::load()
+{
+  transform_frame();
 
-  _feature_bin_file.open(_feature_bin_path, std::ios::in | std::ios::out | std::ios::binary);
-  if (_feature_bin_file.fail()) {
-    std::cerr << "cant open " << _feature_bin_path << '\n';
-    std::cin.get();
-    exit(1);
-  }
+  // the old feature num file stored the size in a slot of sizeof(double) bytes, and the old label num file used sizeof(int) bytes.
+  _feature_store.open(_feature_bin_path, _feature_num_bin_path, max_frame, sizeof(double));
+  _label_store.open(_label_bin_path, _label_num_bin_path, max_frame, sizeof(int));
 
-  _feature_num_bin_file.open(_feature_num_bin_path, std::ios::in | std::ios::out | std::ios::binary);
-  if (_feature_num_bin_file.fail()) {
-    std::cerr << "cant open " << _feature_num_bin_path << '\n';
-    std::cin.get();
-    exit(1);
-  }
+  // replay the saves which may not reach the stores before the tool was killed.
+  _journal.open(_label_bin_path + ".journal");
+  const int replayed = LabelSave::replay(_journal, _feature_store, _label_store, current_save_frame);
 
-  _label_bin_file.open(_label_bin_path, std::ios::in | std::ios::out | std::ios::binary);
-  if (_label_bin_file.fail()) {
-    std::cerr << "cant open " << _label_bin_path << '\n';
-    std::cin.get();
-    exit(1);
-  }
+  if (replayed != 0)
+    _checkpoint();
 
-  _label_num_bin_file.open(_label_num_bin_path, std::ios::in | std::ios::out | std::ios::binary);
-  if (_label_num_bin_file.fail()) {
-    std::cerr << "cant open " << _label_num_bin_path << '\n';
-    std::cin.get();
-    exit(1);
+  // the tool data file is only written at exit, thus the written information is recalculated from the stores.
+  std::vector<int> one_frame_label;
+  _label_table.resize(max_frame);
+  for (int i = 0; i < max_frame; ++i) {
+    if (_label_store.size(i) != 0) {
+      one_frame_label.resize(_label_store.size(i) / sizeof(int));
+      _label_store.read(i, one_frame_label.data());
+      _label_table.set(i, one_frame_label.data(), one_frame_label.size());
+    }
   }
 
-  transform_frame();
-  label_size_vec.resize(max_frame);
-  label_index_vec.resize(max_frame);
-  feature_size_vec.resize(max_frame);
-  feature_index_vec.resize(max_frame);
-  total_frame_segment_vec.resize(max_frame);
-
-  if (std::filesystem::file_size(_label_num_bin_path) == 0) {
-    const int tmp_n = 0;
-    const double tmp_d = 0.0;
-
-    for (int i = 0; i < max_frame; ++i) {
-      _label_num_bin_file.write(reinterpret_cast<const char *>(&tmp_n), sizeof(int));
-      _feature_num_bin_file.write(reinterpret_cast<const char *>(&tmp_d), sizeof(double));
-    }
+  writed_frame_numbers = _label_table.labeled_frames().count();
+  writed_max_frame = _label_table.labeled_frames().last_set();
 
-    _label_num_bin_file.flush();
-    _feature_num_bin_file.flush();
-    _label_num_bin_file.seekp(0, std::ios::beg);
-    _label_num_bin_file.seekg(0, std::ios::beg);
-  }
-  else {
-    for (int i = 0; i < max_frame; ++i) {
-      _label_num_bin_file.read(reinterpret_cast<char *>(&label_size_vec[i]), sizeof(int));
-      _feature_num_bin_file.read(reinterpret_cast<char *>(&feature_size_vec[i]), sizeof(double));
-
-      for (int j = 0; j < i; ++j) {
-        label_index_vec[i] += label_size_vec[j];
-        feature_index_vec[i] += feature_size_vec[j];
-      }
-    }
-  }
+  _writer.start([this](const std::vector<const LabelSaveRecord *> &batch) { _write_batch(batch); });
 }
 
 LabelController::~LabelController()
 {
-  std::filesystem::remove(_buf_feature_path);
-  std::filesystem::remove(_buf_label_path);
+  wait_load();
 
-  std::ofstream _tool_data_file(_tool_data_path, std::ios::out | std::ios::trunc);
+  // write all the saves in the queue before the checkpoint, the stores aren't opened if the load failed before the journal.
+  _exporter.cancel();
+  _writer.stop();
+  if (_journal.is_open())
+    _checkpoint();
+
+  // write a new tool data file then replace the old one, thus a crash won't leave a half-written file.
+  const std::string tmp_tool_data_path = _tool_data_path + ".tmp";
+  std::ofstream _tool_data_file(tmp_tool_data_path, std::ios::out | std::ios::trunc);
   if (_tool_data_file.fail()) {
-    std::cerr << "cant open " << _tool_data_path << '\n';
+    std::cerr << "cant open " << tmp_tool_data_path << '\n';
     std::cin.get();
     exit(1);
   }
@@ -622,4 +366,7 @@ LabelController::~LabelController()
                   << current_save_frame << '\n'
                   << writed_max_frame << '\n'
                   << writed_frame_numbers;
+
+  _tool_data_file.close();
+  std::filesystem::rename(tmp_tool_data_path, _tool_data_path);
 }
\ No newline at end of file
@@ -13,29 +13,38 @@
 #define LABEL_CONTROLLER_H__
 
 #include "Controller.h"
+#include "log_store.h"
+#include "label_journal.h"
+#include "LabelWriter.h"
+#include "label_bitmap.h"
+#include "LabelExporter.h"
+#include "SpatialGrid.h"
 #include "Eigen/Eigen"
 
 #include <vector>
 
 class LabelController : public AnimationController {
 public:
-  void output_feature_data();
-  void output_json_label_data();
-  void output_xy_label_data();
+  void start_export(const LabelExportType type);
+  void cancel_export();
+  bool is_exporting() const { return _exporter.running(); }
+  float export_progress() const { return _exporter.progress(); }
 
   void check_clean_data();
   void check_load_data();
   void check_update_frame() override;
   void check_save_data();
+  void load() override;
+
+  int next_unlabeled_frame() const;
+  std::size_t label_memory_bytes() const;
 
   LabelController();
   ~LabelController();
 
 private:
-  void _write_bin_feature_data(const int feature_index, const Eigen::MatrixXd &feature_matrix);
-  void _write_bin_feature_num_data(const int nums);
-  void _write_bin_label_data(const int label_index, const std::vector<int> &segment_label);
-  void _write_bin_label_num_data(const int nums);
+  void _checkpoint();
+  void _write_batch(const std::vector<const LabelSaveRecord *> &batch);
 
 public:
   bool save_label;
@@ -53,7 +62,6 @@ public:
   float label_mouse_area;
 
   int current_save_frame;
-  std::chrono::system_clock::time_point current_save_time;
 
   std::string feature_output_path;
   std::string label_output_path;
@@ -61,24 +69,21 @@ public:
   std::string tmp_label_filepath;
 
   std::vector<int> segment_label;
-  std::vector<int> label_size_vec;
-  std::vector<int> label_index_vec;
-  std::vector<int> feature_size_vec;
-  std::vector<int> feature_index_vec;
-  std::vector<std::vector<Eigen::MatrixXd>> total_frame_segment_vec;
+  SpatialGrid segment_grid;    // the points of the segments in the frame, for the click and the rectangle labeling
 
 private:
   std::string _feature_bin_path;
   std::string _feature_num_bin_path;
   std::string _label_bin_path;
   std::string _label_num_bin_path;
-  std::string _buf_feature_path;
-  std::string _buf_label_path;
 
-  std::fstream _feature_bin_file;
-  std::fstream _feature_num_bin_file;
-  std::fstream _label_bin_file;
-  std::fstream _label_num_bin_file;
+  LogStore _feature_store;    // the features of each frame, indexed by the feature num file
+  LogStore _label_store;    // the labels of each frame, indexed by the label num file
+  LabelJournal _journal;    // the saves which may not be on the disk in the stores yet
+
+  PackedLabelTable _label_table;    // the labels of each frame, updated immediately when saving
+  LabelWriter _writer;    // writes the saves to the journal and the stores, declared after the stores so it stops before the stores are closed
+  LabelExporter _exporter;    // reads the feature store, declared last so it stops first
 };
 
 #endif
\ No newline at end of file
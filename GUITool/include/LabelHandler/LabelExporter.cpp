@@ -0,0 +1,425 @@
+/**
+ * @file LabelExporter.cpp
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The implementation of the background exporter of the feature and label files
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Mes
+ *
+ */
+
+#include "LabelExporter.h"
+#include "Controller.h"
+#include "make_feature.h"
+#include "metric.h"
+#include "json_stream_writer.h"
+#include "task_scheduler.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+namespace {
+  /**
+   * @brief Append the number as `operator<<` with the default format does, i.e. %g with 6 significant digits.
+   */
+  void append_number(std::string &chunk, const double number)
+  {
+    std::array<char, 32> number_buffer;
+    char *end = std::to_chars(number_buffer.data(), number_buffer.data() + number_buffer.size(), number, std::chars_format::general, 6).ptr;
+    chunk.append(number_buffer.data(), end);
+  }
+
+  void append_number(std::string &chunk, const int number)
+  {
+    std::array<char, 16> number_buffer;
+    char *end = std::to_chars(number_buffer.data(), number_buffer.data() + number_buffer.size(), number).ptr;
+    chunk.append(number_buffer.data(), end);
+  }
+
+  /**
+   * @brief Clear the running flag when the export task returns or throws, otherwise the UI would wait for the export forever.
+   */
+  struct RunningReset {
+    std::atomic<bool> &running;
+    ~RunningReset() { running = false; }
+  };
+}    // namespace
+
+/**
+ * @brief Start exporting in the task pool, the exporter must not be running.
+ *
+ * @param job The snapshot of the labels.
+ * @param feature_store The features of the frames, it must not be cleared or resized before the export is done.
+ */
+void LabelExporter::start(LabelExportJob job, LogStore &feature_store)
+{
+  wait();
+
+  _job = std::move(job);
+  _feature_store = &feature_store;
+  _cancel = false;
+  _done_frame_num = 0;
+  _running = true;
+
+  _export_future = TaskScheduler::instance().submit([this] { _run(); });
+}
+
+/**
+ * @brief Stop the export as soon as possible, the output files are not changed.
+ */
+void LabelExporter::cancel()
+{
+  _cancel = true;
+  wait();
+}
+
+void LabelExporter::wait()
+{
+  if (_export_future.valid())
+    _export_future.get();
+}
+
+/**
+ * @brief The progress of the export.
+ *
+ * @return float From 0 to 1.
+ */
+float LabelExporter::progress() const
+{
+  if (_job.frame_vec.empty())
+    return _running ? 0.0f : 1.0f;
+
+  // the npy export reads the frames once, the others write the feature file and the label file
+  const int pass_num = (_job.type == LabelExportType::npy) ? 1 : 2;
+  return static_cast<float>(_done_frame_num) / (pass_num * _job.frame_vec.size());
+}
+
+/**
+ * @brief The export task, write the feature file then the label file, or the .npy files.
+ *        An error (e.g. of the file system) stops the export and is reported here, thus it's not rethrown to the render thread.
+ */
+void LabelExporter::_run()
+{
+  RunningReset reset{ _running };
+  try {
+    _export();
+  }
+  catch (const std::exception &e) {
+    std::cerr << "export failed: " << e.what() << '\n';
+  }
+}
+
+void LabelExporter::_export()
+{
+  if (_job.type == LabelExportType::npy) {
+    _write_npy();
+    return;
+  }
+
+  const bool feature_done = _write_file(_job.feature_output_path, [this](std::ofstream &outfile) {
+    return _write_chunks(&LabelExporter::_format_feature_chunk, [&](const std::string &chunk) { outfile.write(chunk.data(), chunk.size()); });
+  });
+
+  if (feature_done && _job.type == LabelExportType::json) {
+    _write_file(_job.label_output_path, [this](std::ofstream &outfile) {
+      // the frames are written by the resumed writers, the output is the same as ordered_json::dump(2).
+      JsonStreamWriter writer(outfile, 2);
+      writer.begin_object();
+      writer.key("frames");
+      writer.begin_array();
+
+      if (!_write_chunks(&LabelExporter::_format_json_label_chunk, [&](const std::string &chunk) { writer.append_elements(chunk); }))
+        return false;
+
+      writer.end_array();
+      writer.end_object();
+      return true;
+    });
+  }
+  else if (feature_done) {
+    _write_file(_job.label_output_path, [this](std::ofstream &outfile) {
+      return _write_chunks(&LabelExporter::_format_xy_label_chunk, [&](const std::string &chunk) { outfile.write(chunk.data(), chunk.size()); });
+    });
+  }
+}
+
+/**
+ * @brief Write a temporary file then replace the output file, thus the canceled or failed export won't leave a half-written file.
+ *
+ * @param output_path The output file.
+ * @param write The function writing the file, it returns false if the export is canceled.
+ * @return true if the file is written, false if the export is canceled or the file can't be opened or written (e.g. the disk is full).
+ */
+bool LabelExporter::_write_file(const std::string &output_path, const std::function<bool(std::ofstream &outfile)> &write)
+{
+  const std::string tmp_output_path = output_path + ".tmp";
+  bool done;
+  {
+    std::ofstream outfile(tmp_output_path, std::ios::out | std::ios::trunc);
+    if (outfile.fail()) {
+      std::cerr << "Cannot open file " << tmp_output_path << '\n';
+      return false;
+    }
+
+    try {
+      done = write(outfile);
+    }
+    catch (...) {
+      outfile.close();
+      std::filesystem::remove(tmp_output_path);
+      throw;
+    }
+
+    outfile.flush();
+    if (done && !outfile.good()) {
+      std::cerr << "Cannot write file " << tmp_output_path << '\n';
+      done = false;
+    }
+  }
+
+  if (done)
+    std::filesystem::rename(tmp_output_path, output_path);
+  else
+    std::filesystem::remove(tmp_output_path);
+
+  return done;
+}
+
+/**
+ * @brief Write the labeled frames as the columnar .npy arrays, the binary data are copied without formatting.
+ *        For N segments and P points, the arrays are
+ *          features       (N, FEATURE_NUM) float64, the same rows as the feature file
+ *          labels         (N,) int32
+ *          segment_frames (N,) int32, the frame of each segment
+ *          point_offsets  (N + 1,) int64, the points of segment i are points[point_offsets[i]:point_offsets[i + 1]]
+ *          points         (P, 2) float64, the x and y of the points
+ *
+ * @return true if the files are written, false if the export is canceled or a file can't be opened.
+ */
+bool LabelExporter::_write_npy()
+{
+  NpyWriter feature_npy, label_npy, segment_frame_npy, point_offset_npy, point_npy;
+  if (!feature_npy.open(_job.npy_output_prefix + "_features.npy", "<f8", FEATURE_NUM) ||
+      !label_npy.open(_job.npy_output_prefix + "_labels.npy", "<i4", 0) ||
+      !segment_frame_npy.open(_job.npy_output_prefix + "_segment_frames.npy", "<i4", 0) ||
+      !point_offset_npy.open(_job.npy_output_prefix + "_point_offsets.npy", "<i8", 0) ||
+      !point_npy.open(_job.npy_output_prefix + "_points.npy", "<f8", 2))
+    return false;
+
+  MappedWindow raw_bin_window;
+  raw_bin_window.open(_job.raw_bin_path);
+  std::vector<double> feature_buf;    // the features of one frame
+  std::vector<int> label_buf, segment_frame_buf;    // the labels and the frame of the segments in one frame
+  std::vector<std::int64_t> point_offset_buf;    // the end of the points of the segments in one frame
+  Eigen::Matrix<double, Eigen::Dynamic, 2, Eigen::RowMajor> point_buf;    // the points of one frame, row by row
+
+  std::int64_t point_offset = 0;
+  point_offset_npy.write(&point_offset, 1);
+
+  for (const int i : _job.frame_vec) {
+    if (_cancel)
+      break;
+
+    // the features and the labels of the frame must have the same rows, or the frame was saved with another raw data
+    const std::vector<Eigen::MatrixXd> one_frame_segment_vec = _read_frame_segment(raw_bin_window, i);
+    const int segment_num = _job.label_table.segment_num(i);
+    if (!_feature_store->read(i, feature_buf) || static_cast<int>(feature_buf.size()) != segment_num * FEATURE_NUM ||
+        static_cast<int>(one_frame_segment_vec.size()) != segment_num) {
+      ++_done_frame_num;
+      continue;
+    }
+
+    _job.label_table.get(i, label_buf);
+    segment_frame_buf.assign(segment_num, i);
+    point_offset_buf.resize(segment_num);
+
+    int frame_point_num = 0;
+    for (int j = 0; j < segment_num; ++j) {
+      frame_point_num += one_frame_segment_vec[j].rows();
+      point_offset_buf[j] = point_offset + frame_point_num;
+    }
+
+    point_buf.resize(frame_point_num, 2);
+    for (int j = 0, row = 0; j < segment_num; row += one_frame_segment_vec[j].rows(), ++j)
+      point_buf.middleRows(row, one_frame_segment_vec[j].rows()) = one_frame_segment_vec[j].leftCols(2);
+
+    feature_npy.write(feature_buf.data(), segment_num);
+    label_npy.write(label_buf.data(), segment_num);
+    segment_frame_npy.write(segment_frame_buf.data(), segment_num);
+    point_offset_npy.write(point_offset_buf.data(), segment_num);
+    point_npy.write(point_buf.data(), frame_point_num);
+
+    point_offset += frame_point_num;
+    ++_done_frame_num;
+  }
+
+  const bool done = !_cancel;
+  for (NpyWriter *npy : { &feature_npy, &label_npy, &segment_frame_npy, &point_offset_npy, &point_npy })
+    npy->close(done);
+
+  return done;
+}
+
+/**
+ * @brief Format the frames chunk by chunk in parallel, and hand the chunks to the writer in order.
+ *        Only a few chunks are kept in the memory at once.
+ *
+ * @param format_chunk The function formatting the frames [begin, end) of the job into the chunk.
+ * @param write_chunk The function writing the chunk.
+ * @return true if all the frames are written, false if the export is canceled.
+ */
+bool LabelExporter::_write_chunks(const FormatFunction format_chunk, const std::function<void(const std::string &chunk)> &write_chunk)
+{
+  const int frame_num = static_cast<int>(_job.frame_vec.size());
+  TaskScheduler &scheduler = TaskScheduler::instance();
+  const int wave_frame_num = scheduler.thread_num() * CHUNK_FRAME_NUM;
+
+  std::vector<std::string> chunk_vec;
+  for (int wave_begin = 0; wave_begin < frame_num; wave_begin += wave_frame_num) {
+    // format a wave of chunks in parallel
+    const int wave_end = std::min(frame_num, wave_begin + wave_frame_num);
+    chunk_vec.assign((wave_end - wave_begin + CHUNK_FRAME_NUM - 1) / CHUNK_FRAME_NUM, std::string());
+    const bool done = scheduler.parallel_for(
+        wave_begin, wave_end, CHUNK_FRAME_NUM, [&](const int begin, const int end) { (this->*format_chunk)(begin, end, chunk_vec[(begin - wave_begin) / CHUNK_FRAME_NUM]); }, &_cancel);
+    if (!done)
+      return false;    // some chunks are skipped
+
+    // write them in order
+    for (std::size_t i = 0; i < chunk_vec.size(); ++i) {
+      write_chunk(chunk_vec[i]);
+      _done_frame_num += std::min(CHUNK_FRAME_NUM, frame_num - wave_begin - static_cast<int>(i) * CHUNK_FRAME_NUM);
+    }
+  }
+
+  return !_cancel;
+}
+
+/**
+ * @brief Format the features of the frames, as `feature << ' '` for each feature and `'\n'` after the last feature of a segment.
+ */
+void LabelExporter::_format_feature_chunk(const int begin, const int end, std::string &chunk)
+{
+  std::vector<double> buf;    // the features of one frame.
+  for (int f = begin; f < end; ++f) {
+    if (!_feature_store->read(_job.frame_vec[f], buf))
+      continue;
+
+    for (int i{}; i < static_cast<int>(buf.size()); ++i) {
+      append_number(chunk, buf[i]);
+      chunk += " \n"[i % FEATURE_NUM == FEATURE_NUM - 1];
+    }
+  }
+}
+
+/**
+ * @brief Format the frames as the elements of the "frames" array in the json label file.
+ */
+void LabelExporter::_format_json_label_chunk(const int begin, const int end, std::string &chunk)
+{
+  MappedWindow raw_bin_window;
+  raw_bin_window.open(_job.raw_bin_path);
+  std::ostringstream chunk_stream;
+  {
+    JsonStreamWriter writer(chunk_stream, 2);
+    writer.resume(2, begin == 0);
+
+    for (int f = begin; f < end; ++f) {
+      const int i = _job.frame_vec[f];
+      const std::vector<Eigen::MatrixXd> one_frame_segment_vec = _read_frame_segment(raw_bin_window, i);    // the i-th frame
+      const int segment_num = std::min(static_cast<int>(one_frame_segment_vec.size()), _job.label_table.segment_num(i));
+
+      writer.begin_object();
+      writer.key("frame_index");
+      writer.value(i);
+      writer.key("segments");
+      writer.begin_array();
+
+      // iterate through all the segment in the frame
+      for (int j = 0; j < segment_num; ++j) {
+        const Eigen::MatrixXd &segment = one_frame_segment_vec[j];    // the j-th segment in the frame
+        int segment_size = segment.rows();
+
+        writer.begin_object();
+        writer.key("segment_index");
+        writer.value(j);
+        writer.key("label");
+        writer.value(_job.label_table.label(i, j));
+
+        // output the x and y of the segment
+        writer.key("points");
+        writer.begin_object();
+        for (int axis = 0; axis < 2; ++axis) {
+          writer.key(axis == 0 ? "x" : "y");
+          writer.begin_array();
+          for (int k = 0; k < segment_size; ++k)
+            writer.value(segment(k, axis));
+          writer.end_array();
+        }
+        writer.end_object();
+
+        writer.end_object();
+      }
+
+      writer.end_array();
+      writer.end_object();
+    }
+  }
+
+  chunk = std::move(chunk_stream).str();
+}
+
+/**
+ * @brief Format the frames as `x y label` lines.
+ */
+void LabelExporter::_format_xy_label_chunk(const int begin, const int end, std::string &chunk)
+{
+  MappedWindow raw_bin_window;
+  raw_bin_window.open(_job.raw_bin_path);
+  for (int f = begin; f < end; ++f) {
+    const int i = _job.frame_vec[f];
+    const std::vector<Eigen::MatrixXd> one_frame_segment_vec = _read_frame_segment(raw_bin_window, i);    // the i-th frame
+    const int segment_num = std::min(static_cast<int>(one_frame_segment_vec.size()), _job.label_table.segment_num(i));
+
+    // iterate through all the segment in the frame
+    for (int j = 0; j < segment_num; ++j) {
+      const Eigen::MatrixXd &segment = one_frame_segment_vec[j];    // the j-th segment in the frame
+      int segment_size = segment.rows();
+
+      // output the x and y and the corresponding label of the segment
+      for (int k = 0; k < segment_size; ++k) {
+        append_number(chunk, segment(k, 0));
+        chunk += ' ';
+        append_number(chunk, segment(k, 1));
+        chunk += ' ';
+        append_number(chunk, _job.label_table.label(i, j));
+        chunk += '\n';
+      }
+    }
+  }
+}
+
+/**
+ * @brief Derive the segments of a frame from the raw data again, the segmentation is deterministic given the frame and HZ,
+ *        thus the segments of the labeled frames don't need to be kept in the memory.
+ *
+ * @param raw_bin_window The binary raw data opened by the task.
+ * @param frame_i The frame.
+ * @return std::vector<Eigen::MatrixXd> The segments of the frame, in the same order as the labels.
+ */
+std::vector<Eigen::MatrixXd> LabelExporter::_read_frame_segment(MappedWindow &raw_bin_window, const int frame_i) const
+{
+  Eigen::MatrixXd frame_xy_data(_job.HZ, 2);
+  AnimationController::read_frame(raw_bin_window, frame_i, _job.HZ, _job.is_xydata, frame_xy_data);
+
+  return metric::section_to_segment(frame_xy_data);
+}
+
+LabelExporter::~LabelExporter()
+{
+  cancel();
+}
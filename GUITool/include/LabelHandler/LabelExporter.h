@@ -0,0 +1,99 @@
+/**
+ * @file LabelExporter.h
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The declaration of the background exporter of the feature and label files
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Mes
+ *
+ */
+
+#ifndef LABEL_EXPORTER_H__
+#define LABEL_EXPORTER_H__
+
+#include "log_store.h"
+#include "label_bitmap.h"
+#include "npy_writer.h"
+#include "mapped_file.h"
+#include "Eigen/Eigen"
+
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The files would be exported.
+ */
+enum class LabelExportType {
+  json,    // the feature file and the json label file
+  xy,    // the feature file and the xy label file
+  npy    // the .npy arrays of the features, the labels and the points
+};
+
+/**
+ * @brief The snapshot of the labels taken when the export starts, thus the labeling can go on while exporting.
+ */
+struct LabelExportJob {
+  LabelExportType type;
+
+  std::string feature_output_path;
+  std::string label_output_path;
+  std::string npy_output_prefix;    // the .npy files are named <prefix>_<array>.npy
+  std::string raw_bin_path;
+  int HZ;
+  bool is_xydata;
+
+  std::vector<int> frame_vec;    // the labeled frames in order
+  PackedLabelTable label_table;
+};
+
+/**
+ * @brief Export the feature file and the label file as a task of the shared pool. The frames are formatted chunk by chunk in parallel,
+ *        then written in order, the output is the same as formatting them one by one with `operator<<` and `ordered_json::dump(2)`.
+ */
+class LabelExporter {
+public:
+  void start(LabelExportJob job, LogStore &feature_store);
+  void cancel();
+  void wait();
+
+  bool running() const { return _running; }
+  float progress() const;
+
+  LabelExporter() = default;
+  LabelExporter(const LabelExporter &) = delete;
+  LabelExporter &operator=(const LabelExporter &) = delete;
+  ~LabelExporter();
+
+public:
+  static constexpr int CHUNK_FRAME_NUM = 64;    // the numbers of the frames formatted by a task
+
+private:
+  using FormatFunction = void (LabelExporter::*)(const int begin, const int end, std::string &chunk);
+
+  void _run();
+  void _export();
+  bool _write_file(const std::string &output_path, const std::function<bool(std::ofstream &outfile)> &write);
+  bool _write_npy();
+  bool _write_chunks(const FormatFunction format_chunk, const std::function<void(const std::string &chunk)> &write_chunk);
+
+  void _format_feature_chunk(const int begin, const int end, std::string &chunk);
+  void _format_json_label_chunk(const int begin, const int end, std::string &chunk);
+  void _format_xy_label_chunk(const int begin, const int end, std::string &chunk);
+  std::vector<Eigen::MatrixXd> _read_frame_segment(MappedWindow &raw_bin_window, const int frame_i) const;
+
+private:
+  LabelExportJob _job;
+  LogStore *_feature_store = nullptr;
+
+  std::future<void> _export_future;
+  std::atomic<bool> _running = false;
+  std::atomic<bool> _cancel = false;
+  std::atomic<int> _done_frame_num = 0;    // the numbers of the frames written, the feature file and the label file are counted separately
+};
+
+#endif
@@ -0,0 +1,126 @@
+/**
+ * @file LabelWriter.cpp
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The implementation of the background writer of the label saves
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Mes
+ *
+ */
+
+#include "LabelWriter.h"
+
+#include <unordered_map>
+
+constexpr std::size_t LABEL_WRITER_QUEUE_SIZE = 256;
+
+/**
+ * @brief Start the writer thread.
+ *
+ * @param write The function writing a batch of the records, at most one record per frame in the order of the saves.
+ *              It's called in the writer thread.
+ */
+void LabelWriter::start(WriteFunction write)
+{
+  _write = std::move(write);
+  _stop = false;
+  _write_thread = std::thread(&LabelWriter::_write_loop, this);
+}
+
+/**
+ * @brief Hand the record to the writer thread, it returns immediately unless the queue is full.
+ *
+ * @param record The save would be written.
+ */
+void LabelWriter::push(std::unique_ptr<const LabelSaveRecord> record)
+{
+  while (!_queue.push(std::move(record)))
+    std::this_thread::yield();    // the writer is far behind, wait for it.
+
+  ++_push_count;
+  _push_seq.fetch_add(1, std::memory_order_release);
+  _push_seq.notify_one();
+}
+
+/**
+ * @brief Wait until all the records pushed before are written.
+ */
+void LabelWriter::flush()
+{
+  std::uint64_t written = _written_count.load(std::memory_order_acquire);
+  while (written < _push_count) {
+    _written_count.wait(written, std::memory_order_acquire);
+    written = _written_count.load(std::memory_order_acquire);
+  }
+}
+
+/**
+ * @brief Write all the records in the queue, then stop the writer thread.
+ */
+void LabelWriter::stop()
+{
+  if (!_write_thread.joinable())
+    return;
+
+  _stop = true;
+  _push_seq.fetch_add(1, std::memory_order_release);
+  _push_seq.notify_one();
+  _write_thread.join();
+}
+
+/**
+ * @brief The writer thread, it takes all the records in the queue at once as a batch,
+ *        and only writes the latest record of each frame in them.
+ */
+void LabelWriter::_write_loop()
+{
+  std::vector<std::unique_ptr<const LabelSaveRecord>> batch;
+  std::unordered_map<int, std::size_t> latest_index;    // frame -> the index of its latest record in the batch
+  std::vector<const LabelSaveRecord *> write_batch;
+
+  while (true) {
+    const std::uint64_t seq = _push_seq.load(std::memory_order_acquire);
+
+    std::unique_ptr<const LabelSaveRecord> record;
+    while (_queue.pop(record))
+      batch.push_back(std::move(record));
+
+    if (batch.empty()) {
+      if (_stop)
+        break;
+
+      _push_seq.wait(seq, std::memory_order_acquire);
+      continue;
+    }
+
+    latest_index.clear();
+    for (std::size_t i = 0; i < batch.size(); ++i)
+      latest_index[batch[i]->frame] = i;
+
+    write_batch.clear();
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+      if (latest_index[batch[i]->frame] == i)
+        write_batch.push_back(batch[i].get());
+    }
+    _write(write_batch);
+
+    _written_count.fetch_add(batch.size(), std::memory_order_release);
+    _written_count.notify_all();
+    batch.clear();
+  }
+}
+
+LabelWriter::LabelWriter()
+    : _queue(LABEL_WRITER_QUEUE_SIZE)
+{
+  _push_count = 0;
+  _push_seq = 0;
+  _written_count = 0;
+  _stop = false;
+}
+
+LabelWriter::~LabelWriter()
+{
+  stop();
+}
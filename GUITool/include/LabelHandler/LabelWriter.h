@@ -0,0 +1,55 @@
+/**
+ * @file LabelWriter.h
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The declaration of the background writer of the label saves
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Mes
+ *
+ */
+
+#ifndef LABEL_WRITER_H__
+#define LABEL_WRITER_H__
+
+#include "label_save.h"
+#include "spsc_queue.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief The writer thread of the label saves. The render thread pushes the saves through a lock-free queue,
+ *        and the writer thread writes them in batches, the saves of the same frame waiting in the queue are written once.
+ */
+class LabelWriter {
+public:
+  using WriteFunction = std::function<void(const std::vector<const LabelSaveRecord *> &batch)>;
+
+  void start(WriteFunction write);
+  void push(std::unique_ptr<const LabelSaveRecord> record);
+  void flush();
+  void stop();
+
+  LabelWriter();
+  ~LabelWriter();
+
+private:
+  void _write_loop();
+
+private:
+  WriteFunction _write;
+  SpscQueue<std::unique_ptr<const LabelSaveRecord>> _queue;
+  std::thread _write_thread;
+
+  std::uint64_t _push_count;    // the numbers of the records pushed, only used by the render thread
+  std::atomic<std::uint64_t> _push_seq;    // increase after a push, the writer thread waits on it
+  std::atomic<std::uint64_t> _written_count;    // the numbers of the records written (or dropped by coalescing)
+  std::atomic<bool> _stop;
+};
+
+#endif
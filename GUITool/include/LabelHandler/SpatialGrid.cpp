@@ -0,0 +1,122 @@
+/**
+ * @file SpatialGrid.cpp
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The implementation of the uniform grid over the points of a frame
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Mes
+ *
+ */
+
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+ * @brief Build the grid over the bounding box of the points, the numbers of the cells grow with the numbers of the points.
+ *
+ * @param segment_vec The segments of the frame, the x and y of the points are the first two columns.
+ */
+void SpatialGrid::build(const std::vector<Eigen::MatrixXd> &segment_vec)
+{
+  clear();
+
+  double max_x = -std::numeric_limits<double>::infinity(), max_y = max_x;
+  _min_x = std::numeric_limits<double>::infinity(), _min_y = _min_x;
+
+  std::vector<GridPoint> point_vec;
+  for (int i = 0; i < static_cast<int>(segment_vec.size()); ++i) {
+    for (auto data_point : segment_vec[i].rowwise()) {
+      if (!std::isfinite(data_point(0)) || !std::isfinite(data_point(1)))
+        continue;    // it can't be clicked anyway
+
+      point_vec.push_back({ data_point(0), data_point(1), i });
+      _min_x = std::min(_min_x, data_point(0)), max_x = std::max(max_x, data_point(0));
+      _min_y = std::min(_min_y, data_point(1)), max_y = std::max(max_y, data_point(1));
+    }
+  }
+
+  if (point_vec.empty())
+    return;
+
+  const int cells_per_axis = std::clamp(static_cast<int>(std::sqrt(point_vec.size() / POINTS_PER_CELL)), 1, MAX_CELLS_PER_AXIS);
+  _x_cell_num = _y_cell_num = cells_per_axis;
+  _cell_width = std::max((max_x - _min_x) / cells_per_axis, std::numeric_limits<double>::min());
+  _cell_height = std::max((max_y - _min_y) / cells_per_axis, std::numeric_limits<double>::min());
+
+  // counting sort of the points by the cell
+  std::vector<int> cell_vec(point_vec.size());
+  _cell_start_vec.assign(_x_cell_num * _y_cell_num + 1, 0);
+  for (std::size_t i = 0; i < point_vec.size(); ++i) {
+    cell_vec[i] = _cell_y(point_vec[i].y) * _x_cell_num + _cell_x(point_vec[i].x);
+    ++_cell_start_vec[cell_vec[i] + 1];
+  }
+
+  for (std::size_t c = 1; c < _cell_start_vec.size(); ++c)
+    _cell_start_vec[c] += _cell_start_vec[c - 1];
+
+  std::vector<int> fill_vec(_cell_start_vec.begin(), _cell_start_vec.end() - 1);
+  _point_vec.resize(point_vec.size());
+  for (std::size_t i = 0; i < point_vec.size(); ++i)
+    _point_vec[fill_vec[cell_vec[i]]++] = point_vec[i];
+}
+
+/**
+ * @brief Find the segments having a point strictly inside the rectangle.
+ *
+ * @param min_x The left of the rectangle.
+ * @param max_x The right of the rectangle.
+ * @param min_y The bottom of the rectangle.
+ * @param max_y The top of the rectangle.
+ * @param segment_index_vec The index of the segments found, in ascending order.
+ */
+void SpatialGrid::query(const double min_x, const double max_x, const double min_y, const double max_y, std::vector<int> &segment_index_vec) const
+{
+  segment_index_vec.clear();
+  if (_point_vec.empty() || !(min_x < max_x) || !(min_y < max_y))
+    return;
+
+  const int begin_x = _cell_x(min_x), end_x = _cell_x(max_x);
+  const int begin_y = _cell_y(min_y), end_y = _cell_y(max_y);
+  for (int cy = begin_y; cy <= end_y; ++cy) {
+    for (int cx = begin_x; cx <= end_x; ++cx) {
+      const int cell = cy * _x_cell_num + cx;
+      for (int p = _cell_start_vec[cell]; p < _cell_start_vec[cell + 1]; ++p) {
+        const GridPoint &point = _point_vec[p];
+        if ((min_x < point.x && point.x < max_x) && (min_y < point.y && point.y < max_y))
+          segment_index_vec.push_back(point.segment);
+      }
+    }
+  }
+
+  std::sort(segment_index_vec.begin(), segment_index_vec.end());
+  segment_index_vec.erase(std::unique(segment_index_vec.begin(), segment_index_vec.end()), segment_index_vec.end());
+}
+
+void SpatialGrid::clear()
+{
+  _point_vec.clear();
+  _cell_start_vec.clear();
+  _x_cell_num = _y_cell_num = 0;
+}
+
+/**
+ * @brief The column of the cell having the x, the position out of the grid is clamped to the border cell.
+ */
+int SpatialGrid::_cell_x(const double x) const
+{
+  const double cell = std::floor((x - _min_x) / _cell_width);
+  return static_cast<int>(std::clamp(cell, 0.0, static_cast<double>(_x_cell_num - 1)));
+}
+
+/**
+ * @brief The row of the cell having the y, the position out of the grid is clamped to the border cell.
+ */
+int SpatialGrid::_cell_y(const double y) const
+{
+  const double cell = std::floor((y - _min_y) / _cell_height);
+  return static_cast<int>(std::clamp(cell, 0.0, static_cast<double>(_y_cell_num - 1)));
+}
@@ -0,0 +1,53 @@
+/**
+ * @file SpatialGrid.h
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The declaration of the uniform grid over the points of a frame
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Mes
+ *
+ */
+
+#ifndef SPATIAL_GRID_H__
+#define SPATIAL_GRID_H__
+
+#include "Eigen/Eigen"
+
+#include <vector>
+
+/**
+ * @brief The uniform grid over the points of the segments in a frame, it's built once when the frame is loaded,
+ *        then the click and the rectangle only check the points in the cells they cover.
+ *        The points are stored cell by cell, i.e. the cell i has the points in [cell_start[i], cell_start[i + 1]).
+ */
+class SpatialGrid {
+public:
+  void build(const std::vector<Eigen::MatrixXd> &segment_vec);
+  void query(const double min_x, const double max_x, const double min_y, const double max_y, std::vector<int> &segment_index_vec) const;
+
+  void clear();
+
+public:
+  static constexpr int POINTS_PER_CELL = 4;    // the average numbers of the points in a cell
+  static constexpr int MAX_CELLS_PER_AXIS = 256;
+
+private:
+  struct GridPoint {
+    double x, y;
+    int segment;    // the index of the segment in the frame
+  };
+
+  int _cell_x(const double x) const;
+  int _cell_y(const double y) const;
+
+private:
+  std::vector<GridPoint> _point_vec;    // sorted by the cell
+  std::vector<int> _cell_start_vec;    // the first point of each cell, with one more for the end
+
+  double _min_x = 0, _min_y = 0;
+  double _cell_width = 1, _cell_height = 1;
+  int _x_cell_num = 0, _y_cell_num = 0;
+};
+
+#endif
@@ -18,6 +18,7 @@
 #include "logistic.h"
 #include "normalize.h"
 #include "file_handler.h"
+#include "profiler.h"
 
 #include "Eigen/Eigen"
 #include <chrono>
@@ -25,8 +26,9 @@
 #include <algorithm>
 #include <fstream>
 #include <filesystem>
+#include <memory>
 
-static LabelController LC;
+static std::unique_ptr<LabelController> LC;    // created at the first frame, thus the window shows up before the raw data is loaded
 
 static ImVec4 color_arr[] = { ImVec4(192 / 255.0, 238 / 255.0, 228 / 255.0, 1),
                               ImVec4(248 / 255.0, 249 / 255.0, 136 / 255.0, 1),
@@ -56,7 +58,7 @@ void ShowLabelInformation()
       ImGui::Separator();
 
       if (ImGui::Button("OK", ImVec2(200, 0))) {
-        LC.clean_data = true;
+        LC->clean_data = true;
         ImGui::CloseCurrentPopup();
       }
 
@@ -71,21 +73,21 @@ void ShowLabelInformation()
       ImGuiFileDialog::Instance()->OpenDialog("LoadLabelRawData", "Choose your raw data", ".*", FileHandler::get_MRL_project_root() + "/dataset/raw_data/");
 
     ImGui::SameLine();
-    ImGui::Text("path: %s", LC.raw_data_path.c_str());
+    ImGui::Text("path: %s", LC->raw_data_path.c_str());
     // display
     if (ImGuiFileDialog::Instance()->Display("LoadLabelRawData", ImGuiWindowFlags_NoCollapse, ImVec2(600, 500))) {
       // action if OK
       if (ImGuiFileDialog::Instance()->IsOk()) {
-        LC.auto_play = false;
-        LC.replay = false;
-        LC.clean_data = true;
-        LC.load_data = true;
+        LC->auto_play = false;
+        LC->replay = false;
+        LC->clean_data = true;
+        LC->load_data = true;
 
         std::string filePathName = ImGuiFileDialog::Instance()->GetFilePathName();
         std::string filePath = ImGuiFileDialog::Instance()->GetCurrentPath();
 
-        if (filePath != LC.raw_data_path)
-          LC.raw_data_path = filePathName;
+        if (filePath != LC->raw_data_path)
+          LC->raw_data_path = filePathName;
       }
 
       ImGuiFileDialog::Instance()->Close();
@@ -96,7 +98,7 @@ void ShowLabelInformation()
       ImGuiFileDialog::Instance()->OpenDialog("LoadLabelFeatureData", "Choose the feature data you wanna write to", ".*", FileHandler::get_MRL_project_root() + "/");
 
     ImGui::SameLine();
-    ImGui::Text("path: %s", LC.feature_output_path.c_str());
+    ImGui::Text("path: %s", LC->feature_output_path.c_str());
 
     // display
     if (ImGuiFileDialog::Instance()->Display("LoadLabelFeatureData", ImGuiWindowFlags_NoCollapse, ImVec2(600, 500))) {
@@ -104,7 +106,7 @@ void ShowLabelInformation()
       if (ImGuiFileDialog::Instance()->IsOk()) {
         std::string filePathName = ImGuiFileDialog::Instance()->GetFilePathName();
         std::string filePath = ImGuiFileDialog::Instance()->GetCurrentPath();
-        LC.feature_output_path = filePathName;
+        LC->feature_output_path = filePathName;
       }
 
       ImGuiFileDialog::Instance()->Close();
@@ -115,7 +117,7 @@ void ShowLabelInformation()
       ImGuiFileDialog::Instance()->OpenDialog("LoadLabelLabelData", "Choose the label data you wanna write to", ".*", FileHandler::get_MRL_project_root() + "/");
 
     ImGui::SameLine();
-    ImGui::Text("path: %s", LC.label_output_path.c_str());
+    ImGui::Text("path: %s", LC->label_output_path.c_str());
 
     // display
     if (ImGuiFileDialog::Instance()->Display("LoadLabelLabelData", ImGuiWindowFlags_NoCollapse, ImVec2(600, 500))) {
@@ -123,7 +125,7 @@ void ShowLabelInformation()
       if (ImGuiFileDialog::Instance()->IsOk()) {
         std::string filePathName = ImGuiFileDialog::Instance()->GetFilePathName();
         std::string filePath = ImGuiFileDialog::Instance()->GetCurrentPath();
-        LC.label_output_path = filePathName;
+        LC->label_output_path = filePathName;
       }
 
       ImGuiFileDialog::Instance()->Close();
@@ -131,197 +133,239 @@ void ShowLabelInformation()
 
     /*----------Robot HZ----------*/
     ImVec2 current_windows_size = ImGui::GetWindowSize();
-    static int current_HZ = LC.HZ;
+    static int current_HZ = LC->HZ;
 
     if (ImGui::Button("720")) {
-      LC.HZ = 720;
-      LC.clean_data = true;
-      LC.load_data = true;
+      LC->HZ = 720;
+      LC->clean_data = true;
+      LC->load_data = true;
 
-      if (current_HZ != LC.HZ) {
-        current_HZ = LC.HZ;
-        LC.max_frame = static_cast<int>(LC.max_frame / 2.0);    // 360->720
+      if (current_HZ != LC->HZ) {
+        current_HZ = LC->HZ;
+        LC->max_frame = static_cast<int>(LC->max_frame / 2.0);    // 360->720
       }
 
-      LC.xy_data = Eigen::MatrixXd::Zero(LC.HZ, 2);
-      LC.frame = 0;
-      LC.update_frame = true;
+      LC->xy_data = Eigen::MatrixXd::Zero(LC->HZ, 2);
+      LC->frame = 0;
+      LC->update_frame = true;
     }
 
     ImGui::SameLine();
     if (ImGui::Button("360")) {
-      LC.HZ = 360;
-      LC.clean_data = true;
-      LC.load_data = true;
+      LC->HZ = 360;
+      LC->clean_data = true;
+      LC->load_data = true;
 
-      if (current_HZ != LC.HZ) {
-        current_HZ = LC.HZ;
-        LC.max_frame *= 2;    // 720->360
+      if (current_HZ != LC->HZ) {
+        current_HZ = LC->HZ;
+        LC->max_frame *= 2;    // 720->360
       }
 
-      LC.xy_data = Eigen::MatrixXd::Zero(LC.HZ, 2);
-      LC.frame = 0;
-      LC.update_frame = true;
+      LC->xy_data = Eigen::MatrixXd::Zero(LC->HZ, 2);
+      LC->frame = 0;
+      LC->update_frame = true;
     }
     ImGui::SameLine();
 
     ImGui::SameLine();
-    ImGui::Text("HZ:%d", LC.HZ);
+    ImGui::Text("HZ:%d", LC->HZ);
 
     /*----------Label Window Size----------*/
     ImGui::Text("Label Window Size Control:");
     ImGui::SameLine();
     ImGui::PushButtonRepeat(true);
 
-    if (ImGui::ArrowButton("label_window_size_left", ImGuiDir_Left) && LC.window_size > 100)
-      --LC.window_size;
+    if (ImGui::ArrowButton("label_window_size_left", ImGuiDir_Left) && LC->window_size > 100)
+      --LC->window_size;
 
     float spacing = ImGui::GetStyle().ItemInnerSpacing.x;
     ImGui::SameLine(0.0f, spacing);
-    if (ImGui::ArrowButton("label_window_size_right", ImGuiDir_Right) && LC.window_size < 2000)
-      ++LC.window_size;
+    if (ImGui::ArrowButton("label_window_size_right", ImGuiDir_Right) && LC->window_size < 2000)
+      ++LC->window_size;
 
     ImGui::PopButtonRepeat();
     ImGui::SameLine(0.0f, spacing);
     ImGui::PushItemWidth(current_windows_size.x / 3.0f);
-    ImGui::SliderInt("Label Window size", &LC.window_size, 100, 2000, "%d");
+    ImGui::SliderInt("Label Window size", &LC->window_size, 100, 2000, "%d");
     ImGui::SameLine();
-    ImGui::Text(":%d", LC.window_size);
+    ImGui::Text(":%d", LC->window_size);
 
     /*----------Label Mouse Area Control----------*/
     ImGui::Text("Mouse Area Control:");
     ImGui::SameLine();
     ImGui::PushButtonRepeat(true);
 
-    if (ImGui::ArrowButton("label_mouse_area_left", ImGuiDir_Left) && !LC.auto_play && LC.label_mouse_area > 0) {
-      LC.update_frame = true;
-      LC.label_mouse_area -= static_cast<float>(0.01);
+    if (ImGui::ArrowButton("label_mouse_area_left", ImGuiDir_Left) && !LC->auto_play && LC->label_mouse_area > 0) {
+      LC->update_frame = true;
+      LC->label_mouse_area -= static_cast<float>(0.01);
     }
 
     ImGui::SameLine(0.0f, spacing);
-    if (ImGui::ArrowButton("label_mouse_area_right", ImGuiDir_Right) && !LC.auto_play && LC.label_mouse_area < 5) {
-      LC.update_frame = true;
-      LC.label_mouse_area += static_cast<float>(0.01);
+    if (ImGui::ArrowButton("label_mouse_area_right", ImGuiDir_Right) && !LC->auto_play && LC->label_mouse_area < 5) {
+      LC->update_frame = true;
+      LC->label_mouse_area += static_cast<float>(0.01);
     }
 
     ImGui::PopButtonRepeat();
     ImGui::SameLine(0.0f, spacing);
     ImGui::PushItemWidth(current_windows_size.x / 3.0f);
-    ImGui::SliderFloat("Label Mouse Area", &LC.label_mouse_area, 0, 5, "%0.01f");
+    ImGui::SliderFloat("Label Mouse Area", &LC->label_mouse_area, 0, 5, "%0.01f");
 
     ImGui::SameLine();
-    ImGui::Text(":%f", LC.label_mouse_area);
+    ImGui::Text(":%f", LC->label_mouse_area);
 
     /*----------Frame Control----------*/
-    ImGui::Text("Max Frame: %d", LC.max_frame);
-    ImGui::Text("Writed Max Frame: %d", LC.writed_max_frame);
-    ImGui::Text("Writed Frame Numbers: %d", LC.writed_frame_numbers);
+    ImGui::Text("Max Frame: %d", LC->max_frame);
+    ImGui::Text("Writed Max Frame: %d", LC->writed_max_frame);
+    ImGui::Text("Writed Frame Numbers: %d", LC->writed_frame_numbers);
 
     ImGui::Text("Frame Control:");
     ImGui::SameLine();
 
     ImGui::PushButtonRepeat(true);
 
-    if ((ImGui::ArrowButton("frame_left", ImGuiDir_Left) || ImGui::IsKeyPressed(ImGuiKey_LeftArrow)) && !LC.auto_play && LC.frame > 0) {
-      LC.update_frame = true;
-      --LC.frame;
+    if ((ImGui::ArrowButton("frame_left", ImGuiDir_Left) || ImGui::IsKeyPressed(ImGuiKey_LeftArrow)) && !LC->auto_play && LC->frame > 0) {
+      LC->update_frame = true;
+      --LC->frame;
     }
 
     ImGui::SameLine(0.0f, spacing);
-    if ((ImGui::ArrowButton("frame_right", ImGuiDir_Right) || ImGui::IsKeyPressed(ImGuiKey_RightArrow)) && !LC.auto_play && LC.frame < LC.max_frame - 1) {
-      LC.update_frame = true;
-      ++LC.frame;
+    if ((ImGui::ArrowButton("frame_right", ImGuiDir_Right) || ImGui::IsKeyPressed(ImGuiKey_RightArrow)) && !LC->auto_play && LC->frame < LC->max_frame - 1) {
+      LC->update_frame = true;
+      ++LC->frame;
     }
 
     ImGui::PopButtonRepeat();
     ImGui::SameLine(0.0f, spacing);
     ImGui::PushItemWidth(current_windows_size.x / 3.0f);
-    if (ImGui::SliderInt("Frame", &LC.frame, 0, LC.max_frame, "%d"))
-      LC.update_frame = true;
+    if (ImGui::SliderInt("Frame", &LC->frame, 0, LC->max_frame, "%d"))
+      LC->update_frame = true;
 
     ImGui::SameLine();
-    ImGui::Text(":%d", LC.frame);
+    ImGui::Text(":%d", LC->frame);
+
+    ImGui::SameLine();
+    if (ImGui::Button("Next Unlabeled") && !LC->auto_play) {
+      if (const int next_frame = LC->next_unlabeled_frame(); next_frame != -1) {
+        LC->update_frame = true;
+        LC->frame = next_frame;
+      }
+    }
 
     /*----------FPS Control----------*/
     ImGui::Text("FPS Control:");
     ImGui::SameLine();
     ImGui::PushButtonRepeat(true);
 
-    if (ImGui::ArrowButton("fps_left", ImGuiDir_Left) && LC.fps > 1)
-      --LC.fps;
+    if (ImGui::ArrowButton("fps_left", ImGuiDir_Left) && LC->fps > 1)
+      --LC->fps;
 
     ImGui::SameLine(0.0f, spacing);
-    if (ImGui::ArrowButton("fps_right", ImGuiDir_Right) && LC.fps < 200)
-      ++LC.fps;
+    if (ImGui::ArrowButton("fps_right", ImGuiDir_Right) && LC->fps < 200)
+      ++LC->fps;
 
     ImGui::SameLine(0.0f, spacing);
     ImGui::PushItemWidth(current_windows_size.x / 3.0f);
-    ImGui::SliderInt("FPS", &LC.fps, 1, 200, "%d");
+    ImGui::SliderInt("FPS", &LC->fps, 1, 200, "%d");
 
     ImGui::PopButtonRepeat();
     ImGui::SameLine();
-    ImGui::Text(":%d", LC.fps);
+    ImGui::Text(":%d", LC->fps);
 
     /*----------Auto play and Replay----------*/
-    ImGui::Checkbox("Auto Play", &LC.auto_play);
-    if (LC.auto_play && LC.update_frame && LC.frame < LC.max_frame - 1) {
-      LC.update_frame = true;
-      ++LC.frame;
+    ImGui::Checkbox("Auto Play", &LC->auto_play);
+    if (LC->auto_play && LC->update_frame && LC->frame < LC->max_frame - 1) {
+      LC->update_frame = true;
+      ++LC->frame;
     }
 
     ImGui::SameLine();
 
-    ImGui::Checkbox("Replay", &LC.replay);
-    if (LC.replay && LC.update_frame && LC.frame >= LC.max_frame - 1) {
-      LC.update_frame = true;
-      LC.frame = 0;
+    ImGui::Checkbox("Replay", &LC->replay);
+    if (LC->replay && LC->update_frame && LC->frame >= LC->max_frame - 1) {
+      LC->update_frame = true;
+      LC->frame = 0;
     }
 
     /*----------Save Label Control----------*/
-    ImGui::Checkbox("Enable Enter Key for Saving File", &LC.enable_enter_save);
+    ImGui::Checkbox("Enable Enter Key for Saving File", &LC->enable_enter_save);
     if (ImGui::Button("Save Label") ||
         ((ImGui::IsKeyDown(ImGuiKey_LeftCtrl) || ImGui::IsKeyDown(ImGuiKey_RightCtrl)) && ImGui::IsKeyDown(ImGuiKey_S)) ||
-        ((ImGui::IsKeyPressed(ImGuiKey_Enter) || ImGui::IsKeyPressed(ImGuiKey_KeypadEnter)) && LC.enable_enter_save)) {
-      // avoid save too frequently
-      if (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - LC.current_save_time).count() > 100) {
-        LC.current_save_time = std::chrono::system_clock::now();
-        LC.save_label = true;
-        LC.current_save_frame = LC.frame;
-      }
+        ((ImGui::IsKeyPressed(ImGuiKey_Enter) || ImGui::IsKeyPressed(ImGuiKey_KeypadEnter)) && LC->enable_enter_save)) {
+      LC->save_label = true;
+      LC->current_save_frame = LC->frame;
     }
 
-    if (LC.current_save_frame != -1) {
+    if (LC->current_save_frame != -1) {
       ImGui::SameLine();
-      ImGui::Text("Save Label data from Frame: %d", LC.current_save_frame);
+      ImGui::Text("Save Label data from Frame: %d", LC->current_save_frame);
     }
 
-    /*----------Output JSON file Control----------*/
-    if (ImGui::Button("Output JSON label File")) {
-      LC.output_feature_data();
-      LC.output_json_label_data();
+    ImGui::Text("Labeled Frames: %d, Label Memory: %.1f KB", LC->writed_frame_numbers, LC->label_memory_bytes() / 1024.0);
+
+    if (LC->is_exporting()) {
+      /*----------Export Progress----------*/
+      ImGui::ProgressBar(LC->export_progress(), ImVec2(current_windows_size.x / 3.0f, 0.0f));
+      ImGui::SameLine();
+      if (ImGui::Button("Cancel Export"))
+        LC->cancel_export();
     }
+    else {
+      /*----------Output JSON file Control----------*/
+      if (ImGui::Button("Output JSON label File"))
+        LC->start_export(LabelExportType::json);
 
-    /*----------Output JSON file Control----------*/
-    ImGui::SameLine();
-    if (ImGui::Button("Output xy label File")) {
-      LC.output_feature_data();
-      LC.output_xy_label_data();
+      /*----------Output xy file Control----------*/
+      ImGui::SameLine();
+      if (ImGui::Button("Output xy label File"))
+        LC->start_export(LabelExportType::xy);
+
+      /*----------Output npy file Control----------*/
+      ImGui::SameLine();
+      if (ImGui::Button("Output npy Files"))
+        LC->start_export(LabelExportType::npy);
     }
 
     /*----------Show Label Rect and Auto Label----------*/
-    ImGui::Checkbox("Show Label Rect", &LC.show_rect);
+    ImGui::Checkbox("Show Label Rect", &LC->show_rect);
 
     ImGui::SameLine();
-    ImGui::Checkbox("Show Nearest Segment", &LC.show_nearest);
+    ImGui::Checkbox("Show Nearest Segment", &LC->show_nearest);
 
     ImGui::SameLine();
-    ImGui::Checkbox("Auto Label", &LC.auto_label);
+    ImGui::Checkbox("Auto Label", &LC->auto_label);
 
     /*----------------------------------------*/
     ImGui::TreePop();
   }
 }
 
+/**
+ * @brief Create the controller and load it in the background at the first call, and show a placeholder until it's loaded,
+ *        or the error if the loading failed.
+ *
+ * @return true if the controller is loaded.
+ */
+static bool CheckLabelControllerLoaded()
+{
+  if (!LC) {
+    LC = std::make_unique<LabelController>();
+    LC->start_load();
+  }
+
+  if (LC->is_loaded())
+    return true;
+
+  if (LC->load_failed()) {
+    ImGui::Text("Failed to load %s", LC->raw_data_path.c_str());
+    ImGui::Text("%s", LC->load_error().c_str());
+    return false;
+  }
+
+  ImGui::Text("Loading %s ...", LC->raw_data_path.c_str());
+  return false;
+}
+
 /**
  * @brief The main function of Label GUI
  *
@@ -332,15 +376,25 @@ void ShowLabel()
   ImGui::SetNextWindowSize(ImVec2(500, 500), ImGuiCond_FirstUseEver);
   ImGui::Begin("Label Window");
 
-  LC.check_auto_play();
+  if (!CheckLabelControllerLoaded()) {
+    ImGui::End();
+    return;
+  }
+
+  LC->check_auto_play();
   ShowLabelInformation();
-  LC.check_clean_data();
-  LC.check_load_data();
-  LC.check_update_frame();
+  LC->check_clean_data();
+  LC->check_load_data();
+  if (!LC->is_loaded()) {
+    ImGui::End();    // the log chosen in the information failed to load, the error is shown by the next frame
+    return;
+  }
+
+  LC->check_update_frame();
 
   // draw point
   if (ImGui::TreeNodeEx("Label window")) {
-    if (ImPlot::BeginPlot("Label", ImVec2(static_cast<float>(LC.window_size), static_cast<float>(LC.window_size)))) {
+    if (ImPlot::BeginPlot("Label", ImVec2(static_cast<float>(LC->window_size), static_cast<float>(LC->window_size)))) {
       ImPlot::PushStyleVar(ImPlotStyleVar_FillAlpha, 1);
       ImPlot::SetupAxes("x", "y");
       ImPlot::SetupAxisLimits(ImAxis_X1, -5.0, 5.0);
@@ -354,93 +408,87 @@ void ShowLabel()
 
       // the rectangle for label using
       static ImPlotRect rect(-1, 1, -1, 1);
-      if (LC.show_rect)
+      if (LC->show_rect)
         ImPlot::DragRect(0, &rect.X.Min, &rect.Y.Min, &rect.X.Max, &rect.Y.Max, ImVec4(1, 0, 1, 1), ImPlotDragToolFlags_None);
 
-      int nearest_index = -1;
-      double nearest_dis = -1;
-      double nearest_x[2] = {};
-      double nearest_y[2] = {};
-
-      // iterate through the all segments in one frame
-      for (int i = 0; i < LC.segment_vec.size(); ++i) {
-        const Eigen::MatrixXd &segment = LC.segment_vec[i];    // the i-th segment
-
-        Eigen::ArrayXd segment_x = segment.col(0).array();
-        Eigen::ArrayXd segment_y = segment.col(1).array();
-        double X_mean = segment_x.mean();
-        double Y_mean = segment_y.mean();
-        int segment_size = segment_x.size();
-
-        if (ImPlot::IsPlotHovered() && ImGui::IsMouseClicked(0)) {
-          ImPlotPoint click_point = ImPlot::GetPlotMousePos();
-
-          for (auto data_point : segment.rowwise()) {
-            // click the point for labeling
-            if ((data_point(0) - LC.label_mouse_area < click_point.x) && (click_point.x < data_point(0) + LC.label_mouse_area) && (data_point(1) - LC.label_mouse_area < click_point.y) && (click_point.y < data_point(1) + LC.label_mouse_area)) {
-              if (LC.segment_label[i] == 1)
-                LC.segment_label[i] = 0;    // 1 -> 0 (disable the label)
-              else
-                LC.segment_label[i] = 1;    // 0 -> 1 (label the point was not labeled)
-
-              break;
-            }
-          }
+      // the segments having a point near the click, only the cells of the grid around the click are checked
+      static std::vector<int> hit_segment_vec;
+      if (ImPlot::IsPlotHovered() && ImGui::IsMouseClicked(0)) {
+        ImPlotPoint click_point = ImPlot::GetPlotMousePos();
+        LC->segment_grid.query(click_point.x - LC->label_mouse_area, click_point.x + LC->label_mouse_area, click_point.y - LC->label_mouse_area, click_point.y + LC->label_mouse_area, hit_segment_vec);
+
+        for (const int i : hit_segment_vec) {
+          if (LC->segment_label[i] == 1)
+            LC->segment_label[i] = 0;    // 1 -> 0 (disable the label)
+          else
+            LC->segment_label[i] = 1;    // 0 -> 1 (label the point was not labeled)
         }
+      }
 
-        // for rectangle label, label the point in the rectangle
-        if (LC.show_rect && LC.auto_label) {
-          for (auto data_point : segment.rowwise()) {
-            if ((rect.X.Min < data_point(0) && data_point(0) < rect.X.Max) && (rect.Y.Min < data_point(1) && data_point(1) < rect.Y.Max)) {
-              LC.segment_label[i] = 1;
+      // for rectangle label, label the segments having a point in the rectangle
+      if (LC->show_rect && LC->auto_label) {
+        LC->segment_grid.query(rect.X.Min, rect.X.Max, rect.Y.Min, rect.Y.Max, hit_segment_vec);
+        for (const int i : hit_segment_vec)
+          LC->segment_label[i] = 1;
+      }
 
-              break;
-            }
-          }
-        }
+      // the class of each segment, the red one if it was labeled, otherwise choose a color in the color_arr
+      static std::vector<int> class_vec;
+      class_vec.resize(LC->segment_vec.size());
+      for (int i = 0; i < static_cast<int>(LC->segment_vec.size()); ++i)
+        class_vec[i] = (LC->segment_label[i] == 1) ? RenderBuffer::TARGET_CLASS : i % RenderBuffer::COLOR_CLASS_NUM;
+      LC->render_buffer.update(LC->segment_vec, class_vec);
 
-        // find the nearest point in this frame
-        if (LC.show_nearest) {
-          double point_dis = std::sqrt(std::pow(X_mean, 2) + std::pow(Y_mean, 2));
+      // find the nearest segment in this frame by the means of the segments
+      int nearest_index = -1;
+      double nearest_dis = -1;
+      double nearest_x[2] = {};
+      double nearest_y[2] = {};
+      if (LC->show_nearest) {
+        for (int i = 0; i < static_cast<int>(LC->segment_vec.size()); ++i) {
+          double point_dis = std::sqrt(std::pow(LC->render_buffer.mean_x(i), 2) + std::pow(LC->render_buffer.mean_y(i), 2));
           if (point_dis < nearest_dis || nearest_dis == -1) {
             nearest_dis = point_dis;
             nearest_index = i;
-            nearest_x[1] = X_mean;
-            nearest_y[1] = Y_mean;
+            nearest_x[1] = LC->render_buffer.mean_x(i);
+            nearest_y[1] = LC->render_buffer.mean_y(i);
           }
         }
 
-        // plot the point red if it was labeled, otherwise choose a color in the color_arr
-        if (LC.segment_label[i] == 1) {
-          ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 1, ImVec4(1, 0, 0, 1), IMPLOT_AUTO, ImVec4(1, 0, 0, 1));
-          ImPlot::PlotScatter("Target Segment", segment_x.data(), segment_y.data(), segment_size);
-        }
-        else {
-          ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 1, color_arr[i % 9], IMPLOT_AUTO, color_arr[i % 9]);
-          ImPlot::PlotScatter("Normal Point", segment_x.data(), segment_y.data(), segment_size);
+        // for nearest label, label the segment nearest (0, 0), the buffer is rebuilt only if it was not labeled
+        if (LC->auto_label && nearest_index != -1) {
+          LC->segment_label[nearest_index] = 1;
+          class_vec[nearest_index] = RenderBuffer::TARGET_CLASS;
+          LC->render_buffer.update(LC->segment_vec, class_vec);
         }
       }
 
-      // for nearest label, label the point nearest (0, 0)
-      if (LC.show_nearest) {
-        if (LC.auto_label) {
-          LC.segment_label[nearest_index] = 1;
-          Eigen::ArrayXd segment_x = LC.segment_vec[nearest_index].col(0).array();
-          Eigen::ArrayXd segment_y = LC.segment_vec[nearest_index].col(1).array();
-          int segment_size = segment_x.size();
-
-          // plot the nearest segment red (it will cover the original color)
-          ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 1, ImVec4(1, 0, 0, 1), IMPLOT_AUTO, ImVec4(1, 0, 0, 1));
-          ImPlot::PlotScatter("Target Segment", segment_x.data(), segment_y.data(), segment_size);
+      // plot the points class by class
+      {
+        ScopedProfile profile(ProfileStage::plot);
+        for (int c = 0; c < RenderBuffer::CLASS_NUM; ++c) {
+          if (LC->render_buffer.size(c) == 0)
+            continue;
+
+          if (c == RenderBuffer::TARGET_CLASS) {
+            ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 1, ImVec4(1, 0, 0, 1), IMPLOT_AUTO, ImVec4(1, 0, 0, 1));
+            ImPlot::PlotScatter("Target Segment", LC->render_buffer.x(c), LC->render_buffer.y(c), LC->render_buffer.size(c));
+          }
+          else {
+            ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 1, color_arr[c], IMPLOT_AUTO, color_arr[c]);
+            ImPlot::PlotScatter("Normal Point", LC->render_buffer.x(c), LC->render_buffer.y(c), LC->render_buffer.size(c));
+          }
         }
+      }
 
-        // plot the line connect to the nearest segment
+      // plot the line connect to the nearest segment
+      if (LC->show_nearest) {
         ImPlot::SetNextLineStyle(ImVec4(1, 0, 0, 1));
         ImPlot::PlotLine("nearest_line", nearest_x, nearest_y, 2);
       }
 
       // check if it needs to save the data
-      LC.check_save_data();
+      LC->check_save_data();
 
       ImPlot::PopStyleVar();
       ImPlot::EndPlot();
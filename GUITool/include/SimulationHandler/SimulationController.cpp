@@ -11,7 +11,6 @@
 
 #include "SimulationController.h"
 #include "file_handler.h"
-#include "make_feature.h"
 
 #include <filesystem>
 
@@ -23,8 +22,8 @@ void SimulationController::check_update_frame()
   if (update_frame) {
     update_frame = false;
 
-    read_frame();
-    std::tie(feature_matrix, segment_vec) = MakeFeatures::section_to_feature(xy_data);
+    read_frame_data();
+    render_buffer.invalidate();
   }
 }
 
@@ -86,12 +85,12 @@ SimulationController::SimulationController()
   }
 
   Target_X = 0.0, Target_Y = 0.0;
-
-  transform_frame();
 }
 
 SimulationController::~SimulationController()
 {
+  wait_load();
+
   // write the path to the tool file
   std::ofstream _tool_data_file(_tool_data_path, std::ios::out | std::ios::trunc);
   if (_tool_data_file.fail()) {
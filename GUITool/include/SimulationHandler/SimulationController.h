@@ -1,5 +1,5 @@
-#ifndef LABEL_CONTROLLER_H__
-#define LABEL_CONTROLLER_H__
+#ifndef SIMULATION_CONTROLLER_H__
+#define SIMULATION_CONTROLLER_H__
 
 #include "Controller.h"
 
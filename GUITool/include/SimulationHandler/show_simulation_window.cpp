@@ -19,14 +19,17 @@
 #include "logistic.h"
 #include "normalize.h"
 #include "file_handler.h"
+#include "profiler.h"
 
 #include <chrono>
+#include <filesystem>
+#include <memory>
 #include <thread>
 
 static Adaboost<logistic> Model;
 static Normalizer normalizer;
 
-static SimulationController SC;    // simulation animation info
+static std::unique_ptr<SimulationController> SC;    // simulation animation info, created at the first frame
 
 static ImVec4 color_arr[] = { ImVec4(192 / 255.0, 238 / 255.0, 228 / 255.0, 1),
                               ImVec4(248 / 255.0, 249 / 255.0, 136 / 255.0, 1),
@@ -49,7 +52,7 @@ void ShowSimulationInformation()
       ImGuiFileDialog::Instance()->OpenDialog("LoadSimulationRawData", "Choose your raw data", ".*", FileHandler::get_MRL_project_root() + "/");
 
     ImGui::SameLine();
-    ImGui::Text("path: %s", SC.raw_data_path.c_str());
+    ImGui::Text("path: %s", SC->raw_data_path.c_str());
     // display
     if (ImGuiFileDialog::Instance()->Display("LoadSimulationRawData", ImGuiWindowFlags_NoCollapse, ImVec2(600, 500))) {
       // action if OK
@@ -57,11 +60,11 @@ void ShowSimulationInformation()
         std::string filePathName = ImGuiFileDialog::Instance()->GetFilePathName();
         std::string filePath = ImGuiFileDialog::Instance()->GetCurrentPath();
 
-        if (filePath != SC.raw_data_path) {
-          SC.raw_data_path = filePathName;
-          SC.transform_frame();
-          SC.frame = 0;
-          SC.update_frame = true;
+        if (filePath != SC->raw_data_path) {
+          SC->raw_data_path = filePathName;
+          SC->try_transform_frame();
+          SC->frame = 0;
+          SC->update_frame = true;
         }
       }
 
@@ -73,7 +76,7 @@ void ShowSimulationInformation()
       ImGuiFileDialog::Instance()->OpenDialog("LoadSimulationWeightData", "Choose your weight data", ".*", FileHandler::get_MRL_project_root() + "/");
 
     ImGui::SameLine();
-    ImGui::Text("path: %s", SC.weight_data_path.c_str());
+    ImGui::Text("path: %s", SC->weight_data_path.c_str());
     // display
     if (ImGuiFileDialog::Instance()->Display("LoadSimulationWeightData", ImGuiWindowFlags_NoCollapse, ImVec2(600, 500))) {
       // action if OK
@@ -81,11 +84,11 @@ void ShowSimulationInformation()
         std::string filePathName = ImGuiFileDialog::Instance()->GetFilePathName();
         std::string filePath = ImGuiFileDialog::Instance()->GetCurrentPath();
 
-        if (filePath != SC.weight_data_path) {
-          SC.weight_data_path = filePathName;
-          FileHandler::load_weight(SC.weight_data_path, Model, normalizer);
+        if (filePath != SC->weight_data_path) {
+          SC->weight_data_path = filePathName;
+          FileHandler::load_weight(SC->weight_data_path, Model, normalizer);
 
-          SC.update_frame = true;
+          SC->update_frame = true;
         }
       }
 
@@ -94,143 +97,197 @@ void ShowSimulationInformation()
 
     /*----------Print target position----------*/
     float spacing = ImGui::GetStyle().ItemInnerSpacing.x;
-    ImGui::Text("Target is at: [%f, %f]", SC.Target_X, SC.Target_Y);
+    ImGui::Text("Target is at: [%f, %f]", SC->Target_X, SC->Target_Y);
 
     /*----------Robot HZ----------*/
     ImVec2 current_windows_size = ImGui::GetWindowSize();
-    static int current_HZ = SC.HZ;
+    static int current_HZ = SC->HZ;
 
     if (ImGui::Button("720")) {
-      SC.HZ = 720;
-      SC.transform_frame();
+      SC->HZ = 720;
+      SC->try_transform_frame();
 
-      if (current_HZ != SC.HZ) {
-        current_HZ = SC.HZ;
-        SC.max_frame = static_cast<int>(SC.max_frame / 2.0);    // 360->720
+      if (current_HZ != SC->HZ) {
+        current_HZ = SC->HZ;
+        SC->max_frame = static_cast<int>(SC->max_frame / 2.0);    // 360->720
       }
 
-      SC.xy_data = Eigen::MatrixXd::Zero(SC.HZ, 2);
-      SC.frame = 0;
-      SC.update_frame = true;
+      SC->xy_data = Eigen::MatrixXd::Zero(SC->HZ, 2);
+      SC->frame = 0;
+      SC->update_frame = true;
     }
 
     ImGui::SameLine();
     if (ImGui::Button("360")) {
-      SC.HZ = 360;
-      SC.transform_frame();
+      SC->HZ = 360;
+      SC->try_transform_frame();
 
-      if (current_HZ != SC.HZ) {
-        current_HZ = SC.HZ;
-        SC.max_frame *= 2;    // 720->360
+      if (current_HZ != SC->HZ) {
+        current_HZ = SC->HZ;
+        SC->max_frame *= 2;    // 720->360
       }
 
-      SC.xy_data = Eigen::MatrixXd::Zero(SC.HZ, 2);
-      SC.frame = 0;
-      SC.update_frame = true;
+      SC->xy_data = Eigen::MatrixXd::Zero(SC->HZ, 2);
+      SC->frame = 0;
+      SC->update_frame = true;
     }
 
     ImGui::SameLine();
-    ImGui::Text("HZ:%d", SC.HZ);
+    ImGui::Text("HZ:%d", SC->HZ);
 
     /*----------Simulation Window Size----------*/
     ImGui::Text("Simulation Window Size Control:");
     ImGui::SameLine();
     ImGui::PushButtonRepeat(true);
 
-    if (ImGui::ArrowButton("simulation_window_size_left", ImGuiDir_Left) && SC.window_size > 100)
-      --SC.window_size;
+    if (ImGui::ArrowButton("simulation_window_size_left", ImGuiDir_Left) && SC->window_size > 100)
+      --SC->window_size;
 
     ImGui::SameLine(0.0f, spacing);
-    if (ImGui::ArrowButton("simulation_window_size_right", ImGuiDir_Right) && SC.window_size < 2000)
-      ++SC.window_size;
+    if (ImGui::ArrowButton("simulation_window_size_right", ImGuiDir_Right) && SC->window_size < 2000)
+      ++SC->window_size;
 
     ImGui::PopButtonRepeat();
     ImGui::SameLine(0.0f, spacing);
     ImGui::PushItemWidth(current_windows_size.x / 3.0f);
-    ImGui::SliderInt("Simulation Window size", &SC.window_size, 100, 2000, "%d");
+    ImGui::SliderInt("Simulation Window size", &SC->window_size, 100, 2000, "%d");
     ImGui::SameLine();
-    ImGui::Text(":%d", SC.window_size);
+    ImGui::Text(":%d", SC->window_size);
 
     /*----------Frame Control----------*/
-    ImGui::Text("Max Frame: %d", SC.max_frame);
+    ImGui::Text("Max Frame: %d", SC->max_frame);
     ImGui::PushButtonRepeat(true);
 
     ImGui::Text("Frame Control:");
     ImGui::SameLine();
 
-    if (ImGui::ArrowButton("frame_left", ImGuiDir_Left) && !SC.auto_play && SC.frame > 0) {
-      SC.update_frame = true;
-      --SC.frame;
+    if (ImGui::ArrowButton("frame_left", ImGuiDir_Left) && !SC->auto_play && SC->frame > 0) {
+      SC->update_frame = true;
+      --SC->frame;
     }
 
     ImGui::SameLine(0.0f, spacing);
-    if (ImGui::ArrowButton("frame_right", ImGuiDir_Right) && !SC.auto_play && SC.frame < SC.max_frame - 1) {
-      SC.update_frame = true;
-      ++SC.frame;
+    if (ImGui::ArrowButton("frame_right", ImGuiDir_Right) && !SC->auto_play && SC->frame < SC->max_frame - 1) {
+      SC->update_frame = true;
+      ++SC->frame;
     }
 
     ImGui::PopButtonRepeat();
     ImGui::SameLine(0.0f, spacing);
     ImGui::PushItemWidth(current_windows_size.x / 3.0f);
-    if (ImGui::SliderInt("Frame", &SC.frame, 0, SC.max_frame, "%d"))
-      SC.update_frame = true;
+    if (ImGui::SliderInt("Frame", &SC->frame, 0, SC->max_frame, "%d"))
+      SC->update_frame = true;
 
     ImGui::SameLine();
-    ImGui::Text(": %d", SC.frame);
+    ImGui::Text(": %d", SC->frame);
 
     /*----------FPS Control----------*/
     ImGui::Text("FPS Control:");
     ImGui::SameLine();
     ImGui::PushButtonRepeat(true);
 
-    if (ImGui::ArrowButton("fps_left", ImGuiDir_Left) && SC.fps > 1)
-      --SC.fps;
+    if (ImGui::ArrowButton("fps_left", ImGuiDir_Left) && SC->fps > 1)
+      --SC->fps;
 
     ImGui::SameLine(0.0f, spacing);
-    if (ImGui::ArrowButton("fps_right", ImGuiDir_Right) && SC.fps < 200)
-      ++SC.fps;
+    if (ImGui::ArrowButton("fps_right", ImGuiDir_Right) && SC->fps < 200)
+      ++SC->fps;
 
     ImGui::SameLine(0.0f, spacing);
     ImGui::PushItemWidth(current_windows_size.x / 3.0f);
-    ImGui::SliderInt("FPS", &SC.fps, 1, 200, "%d");
+    ImGui::SliderInt("FPS", &SC->fps, 1, 200, "%d");
 
     ImGui::PopButtonRepeat();
     ImGui::SameLine();
-    ImGui::Text(": %d", SC.fps);
+    ImGui::Text(": %d", SC->fps);
 
     /*----------Auto play and Replay----------*/
-    ImGui::Checkbox("Auto Play", &SC.auto_play);
-    if (SC.auto_play && SC.update_frame && SC.frame < SC.max_frame - 1) {
-      SC.update_frame = true;
-      ++SC.frame;
+    ImGui::Checkbox("Auto Play", &SC->auto_play);
+    if (SC->auto_play && SC->update_frame && SC->frame < SC->max_frame - 1) {
+      SC->update_frame = true;
+      ++SC->frame;
     }
 
     ImGui::SameLine();
 
-    ImGui::Checkbox("Replay", &SC.replay);
-    if (SC.replay && SC.update_frame && SC.frame >= SC.max_frame - 1) {
-      SC.update_frame = true;
-      SC.frame = 0;
+    ImGui::Checkbox("Replay", &SC->replay);
+    if (SC->replay && SC->update_frame && SC->frame >= SC->max_frame - 1) {
+      SC->update_frame = true;
+      SC->frame = 0;
     }
 
     ImGui::TreePop();
   }
 }
 
-void ShowSimulation()
+/**
+ * @brief Create the controller and load it in the background at the first call, and show a placeholder until it's loaded,
+ *        or the error if the loading failed.
+ *
+ * @return true if the controller is loaded.
+ */
+static bool CheckSimulationControllerLoaded()
 {
-  FileHandler::load_weight(SC.weight_data_path, Model, normalizer);
+  if (!SC) {
+    SC = std::make_unique<SimulationController>();
+    SC->start_load();
+  }
+
+  if (SC->is_loaded())
+    return true;
+
+  if (SC->load_failed()) {
+    ImGui::Text("Failed to load %s", SC->raw_data_path.c_str());
+    ImGui::Text("%s", SC->load_error().c_str());
+    return false;
+  }
+
+  ImGui::Text("Loading %s ...", SC->raw_data_path.c_str());
+  return false;
+}
+
+/**
+ * @brief Reload the weight only when the file is changed, e.g. rewritten by the training, instead of parsing it every frame.
+ */
+static void CheckWeightUpdated()
+{
+  static std::string loaded_path;
+  static std::filesystem::file_time_type loaded_time;
+
+  std::error_code ec;
+  const auto write_time = std::filesystem::last_write_time(SC->weight_data_path, ec);
+  if (!ec && loaded_path == SC->weight_data_path && write_time == loaded_time)
+    return;
 
+  FileHandler::load_weight(SC->weight_data_path, Model, normalizer);
+  loaded_path = SC->weight_data_path;
+  loaded_time = write_time;
+}
+
+void ShowSimulation()
+{
   ImGui::SetNextWindowPos(ImVec2(550, 50), ImGuiCond_FirstUseEver);
   ImGui::SetNextWindowSize(ImVec2(500, 500), ImGuiCond_FirstUseEver);
   ImGui::Begin("Simulation Window");
 
-  SC.check_auto_play();
+  if (!CheckSimulationControllerLoaded()) {
+    ImGui::End();
+    return;
+  }
+
+  CheckWeightUpdated();
+
+  SC->check_auto_play();
   ShowSimulationInformation();
-  SC.check_update_frame();
+  if (!SC->is_loaded()) {
+    ImGui::End();    // the log chosen in the information failed to load, the error is shown by the next frame
+    return;
+  }
+
+  SC->check_update_frame();
 
   if (ImGui::TreeNodeEx("Simulation window")) {
-    if (ImPlot::BeginPlot("Simulation", ImVec2(static_cast<float>(SC.window_size), static_cast<float>(SC.window_size)))) {
+    if (ImPlot::BeginPlot("Simulation", ImVec2(static_cast<float>(SC->window_size), static_cast<float>(SC->window_size)))) {
       ImPlot::PushStyleVar(ImPlotStyleVar_FillAlpha, 1);
       ImPlot::SetupAxes("x", "y");
       ImPlot::SetupAxisLimits(ImAxis_X1, -5.0, 5.0);
@@ -242,26 +299,47 @@ void ShowSimulation()
       ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 0, ImVec4(1, 0, 0, 1), IMPLOT_AUTO, ImVec4(1, 0, 0, 1));
       ImPlot::PlotScatter("Target Segment", &order_using_xy, &order_using_xy, 1);
 
-      Eigen::MatrixXd target_feature_matrix = normalizer.transform(SC.feature_matrix);
-      Eigen::VectorXd pred_Y = Model.predict(target_feature_matrix);
-
-      for (int i = 0; i < static_cast<int>(SC.segment_vec.size()); ++i) {
-        Eigen::ArrayXd segment_x_data = SC.segment_vec[i].col(0).array();
-        Eigen::ArrayXd segment_y_data = SC.segment_vec[i].col(1).array();
+      Eigen::MatrixXd target_feature_matrix;
+      Eigen::VectorXd pred_Y;
+      {
+        ScopedProfile profile(ProfileStage::normalize);
+        target_feature_matrix = normalizer.transform(SC->feature_matrix);
+      }
+      {
+        ScopedProfile profile(ProfileStage::predict);
+        pred_Y = Model.predict(target_feature_matrix);
+      }
 
-        double *segment_x = segment_x_data.data();
-        double *segment_y = segment_y_data.data();
+      // the class of each segment, the red one if it's predicted as the target, otherwise choose a color in the color_arr
+      static std::vector<int> class_vec;
+      class_vec.resize(SC->segment_vec.size());
+      for (int i = 0; i < static_cast<int>(SC->segment_vec.size()); ++i)
+        class_vec[i] = (pred_Y(i) == 1) ? RenderBuffer::TARGET_CLASS : i % RenderBuffer::COLOR_CLASS_NUM;
+      SC->render_buffer.update(SC->segment_vec, class_vec);
 
+      // the target is the mean of the last predicted segment
+      for (int i = 0; i < static_cast<int>(SC->segment_vec.size()); ++i) {
         if (pred_Y(i) == 1) {
-          ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 1, ImVec4(1, 0, 0, 1), IMPLOT_AUTO, ImVec4(1, 0, 0, 1));
-          ImPlot::PlotScatter("Target Section", segment_x, segment_y, segment_x_data.size());
-
-          SC.Target_X = segment_x_data.mean();
-          SC.Target_Y = segment_y_data.mean();
+          SC->Target_X = SC->render_buffer.mean_x(i);
+          SC->Target_Y = SC->render_buffer.mean_y(i);
         }
-        else {
-          ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 1, color_arr[i % 9], IMPLOT_AUTO, color_arr[i % 9]);
-          ImPlot::PlotScatter("Normal Point", segment_x, segment_y, segment_x_data.size());
+      }
+
+      // plot the points class by class
+      {
+        ScopedProfile profile(ProfileStage::plot);
+        for (int c = 0; c < RenderBuffer::CLASS_NUM; ++c) {
+          if (SC->render_buffer.size(c) == 0)
+            continue;
+
+          if (c == RenderBuffer::TARGET_CLASS) {
+            ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 1, ImVec4(1, 0, 0, 1), IMPLOT_AUTO, ImVec4(1, 0, 0, 1));
+            ImPlot::PlotScatter("Target Section", SC->render_buffer.x(c), SC->render_buffer.y(c), SC->render_buffer.size(c));
+          }
+          else {
+            ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 1, color_arr[c], IMPLOT_AUTO, color_arr[c]);
+            ImPlot::PlotScatter("Normal Point", SC->render_buffer.x(c), SC->render_buffer.y(c), SC->render_buffer.size(c));
+          }
         }
       }
 
@@ -12,90 +12,48 @@
 #include "Controller.h"
 #include "metric.h"
 #include "file_handler.h"
+#include "profiler.h"
+#include "task_scheduler.h"
+
+#include <iostream>
+#include <stdexcept>
 
 /**
- * @brief Transform the raw data into binary data
+ * @brief Transform the raw data into binary data, the binary data is shared with the other windows viewing the same log with the same HZ.
+ *
+ * @throw std::runtime_error The raw data can't be read or transformed.
  */
 void AnimationController::transform_frame()
 {
-  max_frame = 0;
-
-  // if the file has been open, it means it was going to load another file, so close it
-  if (_raw_bin_open)
-    _raw_bin_file.close();
-  else
-    _raw_bin_open = true;
-
-
-  int r_buf[360] = {};
-  {
-    std::ifstream infile(raw_data_path);
-    if (infile.fail()) {
-      std::cerr << "cant found " << raw_data_path << '\n';
-      std::cin.get();
-      exit(1);
-    }
-
-    std::ofstream outfile(_raw_bin_path, std::ios::binary | std::ios::trunc);
-    if (outfile.fail()) {
-      std::cerr << "cant found " << _raw_bin_path << '\n';
-      std::cin.get();
-      exit(1);
-    }
-
-    std::string line;
-    std::stringstream ss;
-    double x, y;
-    int theta_cnt = 0;
-
-    while (std::getline(infile, line)) {
-      ++max_frame;
+  // if the file has been open, it means it was going to load another file, so close it.
+  // the store is released first, thus loading the same log again transforms it again unless another window is viewing it.
+  _raw_bin_window.close();
+  _frame_store.reset();
 
-      ss << line;
-      ss >> x >> y;
+  _frame_store = FrameStore::acquire(raw_data_path, _raw_bin_path, HZ);
+  is_xydata = _frame_store->is_xydata();
 
-      // buffer the first 360 line for checking if the data is rtheta data later
-      if (theta_cnt < 360)
-        r_buf[theta_cnt++] = static_cast<int>(x * 10);
-
-      // write the binary data
-      outfile.write(reinterpret_cast<char *>(&x), sizeof(double));
-      outfile.write(reinterpret_cast<char *>(&y), sizeof(double));
-
-      ss.str("");
-      ss.clear();
-    }
-  }
-
-  // check if the data is xy data or rtheta data, the theta difference of minibot and turtlebot was 0.5 and 1
-  int theta1 = r_buf[0], theta2 = r_buf[1];
-  bool rtheta_data = true;
-
-  // check the first data
-  if (!(theta2 - theta1 == 5 || theta2 - theta1 == 10))
-    rtheta_data = false;
+  max_frame = _frame_store->frame_num();
+  --max_frame;    // 0 ~ max_frame-1
 
-  // check all the remain data in the first 360 line
-  for (int i = 2; i < 360; ++i) {
-    theta1 = theta2;
-    theta2 = r_buf[i];
+  if (!_raw_bin_window.open(_frame_store->raw_bin_path()))
+    throw std::runtime_error("cant open " + _frame_store->raw_bin_path());
+}
 
-    // if the theta difference is not 0.5 or 1, it means the data is xy data
-    if (!(theta2 - theta1 == 5 || theta2 - theta1 == 10)) {
-      rtheta_data = false;
-      break;
-    }
+/**
+ * @brief Transform the raw data in the GUI thread, e.g. when another log is chosen. If it fails, the window shows the error as a failed `load()`.
+ *
+ * @return true if the raw data is transformed.
+ */
+bool AnimationController::try_transform_frame()
+{
+  try {
+    transform_frame();
+    return true;
   }
-  is_xydata = !rtheta_data;
-
-  max_frame /= HZ;
-  --max_frame;    // 0 ~ max_frame-1
-
-  _raw_bin_file.open(_raw_bin_path, std::ios::in | std::ios::binary);
-  if (_raw_bin_file.fail()) {
-    std::cerr << "cant open " << _raw_bin_path << '\n';
-    std::cin.get();
-    exit(1);
+  catch (const std::exception &e) {
+    _fail_load(e.what());
+    return false;
   }
 }
 
@@ -105,15 +63,45 @@ void AnimationController::transform_frame()
  */
 void AnimationController::read_frame()
 {
-  _raw_bin_file.seekg(frame * sizeof(double) * 2 * HZ, std::ios::beg);
+  read_frame(_raw_bin_window, frame, HZ, is_xydata, xy_data);
+}
+
+/**
+ * @brief Read the frame with its segments and features, the segmentation is cached in the store shared with the other windows.
+ */
+void AnimationController::read_frame_data()
+{
+  const std::shared_ptr<const FrameData> frame_data = _frame_store->frame_data(_raw_bin_window, frame);
+  xy_data = frame_data->xy_data;
+  feature_matrix = frame_data->feature_matrix;
+  segment_vec = frame_data->segment_vec;
+}
 
-  for (int i{}; i < HZ; ++i) {
-    _raw_bin_file.read(reinterpret_cast<char *>(&xy_data(i, 0)), sizeof(double));
-    _raw_bin_file.read(reinterpret_cast<char *>(&xy_data(i, 1)), sizeof(double));
+/**
+ * @brief read the given frame in the binary laser data into the matrix, it doesn't touch the controller,
+ *        thus another thread can read the frames by its own window. The offset is 64-bit, the log can be larger than 2GB.
+ *
+ * @param raw_bin_window The binary file transformed by `transform_frame`.
+ * @param frame_i The frame would be read.
+ * @param HZ The numbers of the points in a frame.
+ * @param is_xydata If the data is xy data, otherwise it's rtheta data.
+ * @param data The HZ*2 matrix storing the xy data of the frame.
+ */
+void AnimationController::read_frame(MappedWindow &raw_bin_window, const int frame_i, const int HZ, const bool is_xydata, Eigen::MatrixXd &data)
+{
+  ScopedProfile profile(ProfileStage::read_frame);
+  const std::int64_t frame_bytes = static_cast<std::int64_t>(HZ) * 2 * sizeof(double);
+  const char *frame_data = raw_bin_window.map(frame_i * frame_bytes, frame_bytes);
+  if (frame_data == nullptr) {
+    data.setZero(HZ, 2);    // the frame is out of the file
+    return;
   }
 
+  // the points are stored as x y pairs
+  data = Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, 2, Eigen::RowMajor>>(reinterpret_cast<const double *>(frame_data), HZ, 2);
+
   if (!is_xydata)
-    metric::rtheta_to_xy(xy_data, HZ);
+    metric::rtheta_to_xy(data, HZ);
 }
 
 /**
@@ -134,6 +122,58 @@ void AnimationController::check_auto_play()
   }
 }
 
+/**
+ * @brief The heavy initialization of the controller, which is transforming the raw data by default.
+ *        It runs in the task pool, the GUI must not touch the controller until `is_loaded()`, except reading the paths.
+ */
+void AnimationController::load()
+{
+  transform_frame();
+}
+
+/**
+ * @brief Run `load()` in the task pool, thus the window shows up before the raw data is transformed.
+ *        The error of `load()` is kept for the window instead of leaving the task, otherwise `wait_load()` would rethrow it in the destructor.
+ */
+void AnimationController::start_load()
+{
+  wait_load();
+  _loaded = false;
+  _load_failed = false;
+  _load_future = TaskScheduler::instance().submit([this] {
+    try {
+      const auto start = std::chrono::steady_clock::now();
+      load();
+      _load_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      std::cout << "loaded " << raw_data_path << " in " << _load_seconds << " s\n";
+      _loaded = true;
+    }
+    catch (const std::exception &e) {
+      _fail_load(e.what());
+    }
+  });
+}
+
+/**
+ * @brief Mark the controller as not loaded with the error, the window shows the error instead of the data.
+ */
+void AnimationController::_fail_load(const std::string &error)
+{
+  _loaded = false;
+  std::cerr << "cant load " << raw_data_path << ": " << error << '\n';
+  _load_error = error;
+  _load_failed = true;
+}
+
+/**
+ * @brief Wait for `load()`, it must be called before destroying a controller which may be loading.
+ */
+void AnimationController::wait_load()
+{
+  if (_load_future.valid())
+    _load_future.get();
+}
+
 AnimationController::AnimationController()
 {
   fps = 60;
@@ -146,6 +186,5 @@ AnimationController::AnimationController()
   auto_play = false;
   replay = false;
 
-  _raw_bin_open = false;
   is_xydata = false;
 }
\ No newline at end of file
@@ -12,21 +12,38 @@
 #ifndef CONTROLLER_H__
 #define CONTROLLER_H__
 
+#include "mapped_file.h"
+#include "RenderBuffer.h"
+#include "FrameStore.h"
 #include "Eigen/Eigen"
 
+#include <atomic>
 #include <chrono>
 #include <string>
 #include <fstream>
+#include <future>
+#include <memory>
 #include <vector>
 
 class AnimationController {
 public:
   void transform_frame();
+  bool try_transform_frame();
   void read_frame();
+  void read_frame_data();
+  static void read_frame(MappedWindow &raw_bin_window, const int frame_i, const int HZ, const bool is_xydata, Eigen::MatrixXd &data);
 
   virtual void check_auto_play();
   virtual void check_update_frame() = 0;
 
+  virtual void load();
+  void start_load();
+  void wait_load();
+  bool is_loaded() const { return _loaded; }
+  bool load_failed() const { return _load_failed; }
+  const std::string &load_error() const { return _load_error; }    // only read after `load_failed()` is true
+  double load_seconds() const { return _load_seconds; }
+
   AnimationController();
 
 public:
@@ -43,17 +60,27 @@ public:
   Eigen::MatrixXd xy_data;
   Eigen::MatrixXd feature_matrix;
   std::vector<Eigen::MatrixXd> segment_vec;
+  RenderBuffer render_buffer;    // the points of segment_vec grouped by the color
 
   std::string raw_data_path;
 
 protected:
+  void _fail_load(const std::string &error);
+
+protected:
+  std::future<void> _load_future;
+  std::atomic<bool> _loaded = false;
+  std::atomic<bool> _load_failed = false;
+  double _load_seconds = 0;    // written before _loaded is set
+  std::string _load_error;    // written before _load_failed is set
+
   bool is_xydata;
 
   std::chrono::system_clock::time_point _current_time;
   std::string _tool_data_path;
   std::string _raw_bin_path;
-  std::ifstream _raw_bin_file;
-  bool _raw_bin_open;
+  std::shared_ptr<FrameStore> _frame_store;    // the binary data and the segmented frames, shared by the windows viewing the same log
+  MappedWindow _raw_bin_window;
 };
 
 #endif
\ No newline at end of file
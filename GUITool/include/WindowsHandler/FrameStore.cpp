@@ -0,0 +1,188 @@
+/**
+ * @file FrameStore.cpp
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The implementation of the frame store shared by the windows viewing the same raw log
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Mes
+ *
+ */
+
+#include "FrameStore.h"
+#include "Controller.h"
+#include "make_feature.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+  std::mutex registry_mutex;
+  std::vector<std::weak_ptr<FrameStore>> registry;    // the living stores
+}    // namespace
+
+bool FrameStore::Key::operator==(const Key &other) const
+{
+  return raw_data_path == other.raw_data_path && file_size == other.file_size && write_time == other.write_time && HZ == other.HZ;
+}
+
+/**
+ * @brief Get the store of the raw log, it's transformed only if no other window is viewing the same log with the same HZ.
+ *        If another thread is transforming the log, it waits until the transform is done.
+ *
+ * @param raw_data_path The raw log.
+ * @param raw_bin_path The binary file the log is transformed into, a suffix is added if a living store of another log is using it.
+ * @param HZ The numbers of the points in a frame.
+ * @return std::shared_ptr<FrameStore> The transformed store, it's released when the last owner drops it.
+ * @throw std::runtime_error The raw log can't be read or the binary file can't be written, the transform is retried by the next `acquire`.
+ */
+std::shared_ptr<FrameStore> FrameStore::acquire(const std::string &raw_data_path, const std::string &raw_bin_path, const int HZ)
+{
+  std::error_code ec;
+  const std::filesystem::path canonical_path = std::filesystem::canonical(raw_data_path, ec);
+  const std::uintmax_t file_size = ec ? 0 : std::filesystem::file_size(canonical_path, ec);
+  const std::filesystem::file_time_type write_time = ec ? std::filesystem::file_time_type{} : std::filesystem::last_write_time(canonical_path, ec);
+  if (ec)
+    throw std::runtime_error("cant found " + raw_data_path);
+
+  const Key key{ canonical_path.string(), file_size, write_time, HZ };
+
+  std::shared_ptr<FrameStore> store;
+  {
+    std::lock_guard lock(registry_mutex);
+    registry.erase(std::remove_if(registry.begin(), registry.end(), [](const std::weak_ptr<FrameStore> &weak) { return weak.expired(); }), registry.end());
+
+    for (const std::weak_ptr<FrameStore> &weak : registry) {
+      std::shared_ptr<FrameStore> living = weak.lock();
+      if (living && living->_key == key) {
+        store = std::move(living);
+        break;
+      }
+    }
+
+    if (!store) {
+      // don't overwrite the binary file mapped by another store
+      std::string bin_path = raw_bin_path;
+      for (int suffix = 1;; ++suffix) {
+        const bool used = std::any_of(registry.begin(), registry.end(), [&](const std::weak_ptr<FrameStore> &weak) {
+          const std::shared_ptr<FrameStore> living = weak.lock();
+          return living && living->_raw_bin_path == bin_path;
+        });
+        if (!used)
+          break;
+
+        bin_path = raw_bin_path + '.' + std::to_string(suffix);
+      }
+
+      store = std::shared_ptr<FrameStore>(new FrameStore(key, bin_path));
+      registry.push_back(store);
+    }
+  }
+
+  // transform outside the registry lock, thus the other logs can be acquired meanwhile
+  std::call_once(store->_transform_flag, [&] { store->_transform(); });
+  return store;
+}
+
+FrameStore::FrameStore(const Key &key, const std::string &raw_bin_path)
+    : _key(key), _raw_bin_path(raw_bin_path), _HZ(key.HZ), _cache(CACHE_FRAME_NUM)
+{
+}
+
+/**
+ * @brief Transform the raw log into the binary file, and check if it's xy data or rtheta data.
+ *        If it throws, the `call_once` of `acquire` isn't done, thus the next `acquire` transforms it again.
+ *
+ * @throw std::runtime_error The raw log can't be read or the binary file can't be written.
+ */
+void FrameStore::_transform()
+{
+  int r_buf[360] = {};
+  _line_num = 0;
+  {
+    std::ifstream infile(_key.raw_data_path);
+    if (infile.fail())
+      throw std::runtime_error("cant found " + _key.raw_data_path);
+
+    std::ofstream outfile(_raw_bin_path, std::ios::binary | std::ios::trunc);
+    if (outfile.fail())
+      throw std::runtime_error("cant found " + _raw_bin_path);
+
+    std::string line;
+    double x, y;
+    int theta_cnt = 0;
+
+    while (std::getline(infile, line)) {
+      ++_line_num;
+
+      // strtod reads the "nan" and "inf" returns, which the stream can't read
+      char *end = nullptr;
+      x = std::strtod(line.c_str(), &end);
+      y = std::strtod(end, nullptr);
+
+      // buffer the first 360 line for checking if the data is rtheta data later
+      if (theta_cnt < 360)
+        r_buf[theta_cnt++] = std::isfinite(x) ? static_cast<int>(x * 10) : 0;
+
+      // write the binary data
+      outfile.write(reinterpret_cast<char *>(&x), sizeof(double));
+      outfile.write(reinterpret_cast<char *>(&y), sizeof(double));
+    }
+
+    outfile.flush();
+    if (!outfile.good())
+      throw std::runtime_error("cant write " + _raw_bin_path);
+  }
+
+  // check if the data is xy data or rtheta data, the theta difference of minibot and turtlebot was 0.5 and 1
+  int theta1 = r_buf[0], theta2 = r_buf[1];
+  bool rtheta_data = true;
+
+  // check the first data
+  if (!(theta2 - theta1 == 5 || theta2 - theta1 == 10))
+    rtheta_data = false;
+
+  // check all the remain data in the first 360 line
+  for (int i = 2; i < 360; ++i) {
+    theta1 = theta2;
+    theta2 = r_buf[i];
+
+    // if the theta difference is not 0.5 or 1, it means the data is xy data
+    if (!(theta2 - theta1 == 5 || theta2 - theta1 == 10)) {
+      rtheta_data = false;
+      break;
+    }
+  }
+  _is_xydata = !rtheta_data;
+}
+
+/**
+ * @brief Get the frame with its segments and features, the frame is segmented only if it's not in the cache.
+ *
+ * @param raw_bin_window The window of the caller on the binary file, which is used if the frame isn't in the cache.
+ * @param frame The frame.
+ * @return std::shared_ptr<const FrameData> The segmented frame, it's never changed.
+ */
+std::shared_ptr<const FrameData> FrameStore::frame_data(MappedWindow &raw_bin_window, const int frame)
+{
+  {
+    std::lock_guard lock(_cache_mutex);
+    for (const std::shared_ptr<const FrameData> &data : _cache) {
+      if (data && data->frame == frame)
+        return data;
+    }
+  }
+
+  auto data = std::make_shared<FrameData>();
+  data->frame = frame;
+  AnimationController::read_frame(raw_bin_window, frame, _HZ, _is_xydata, data->xy_data);
+  std::tie(data->feature_matrix, data->segment_vec) = MakeFeatures::section_to_feature(data->xy_data);
+
+  std::lock_guard lock(_cache_mutex);
+  _cache[_cache_next] = data;
+  _cache_next = (_cache_next + 1) % CACHE_FRAME_NUM;
+  return data;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file FrameStore.h
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The declaration of the frame store shared by the windows viewing the same raw log
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Mes
+ *
+ */
+
+#ifndef FRAME_STORE_H__
+#define FRAME_STORE_H__
+
+#include "mapped_file.h"
+#include "Eigen/Eigen"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A frame with its segments and features.
+ */
+struct FrameData {
+  int frame;
+  Eigen::MatrixXd xy_data;
+  Eigen::MatrixXd feature_matrix;
+  std::vector<Eigen::MatrixXd> segment_vec;
+};
+
+/**
+ * @brief The binary file transformed from a raw log, with the cache of the segmented frames.
+ *        The stores are reference counted and keyed by the raw log (the path, the size and the write time) and the HZ,
+ *        thus the Label window and the Simulation window viewing the same log transform it once and share the segmentation.
+ *        Each controller keeps its own frame and its own `MappedWindow` on the binary file.
+ */
+class FrameStore {
+public:
+  static std::shared_ptr<FrameStore> acquire(const std::string &raw_data_path, const std::string &raw_bin_path, const int HZ);
+
+  std::shared_ptr<const FrameData> frame_data(MappedWindow &raw_bin_window, const int frame);
+
+  const std::string &raw_bin_path() const { return _raw_bin_path; }
+  int HZ() const { return _HZ; }
+  int frame_num() const { return static_cast<int>(_line_num / _HZ); }
+  bool is_xydata() const { return _is_xydata; }
+
+  FrameStore(const FrameStore &) = delete;
+  FrameStore &operator=(const FrameStore &) = delete;
+
+public:
+  static constexpr int CACHE_FRAME_NUM = 64;    // the segmented frames kept in the cache
+
+private:
+  struct Key {
+    std::string raw_data_path;    // the canonical path
+    std::uintmax_t file_size;
+    std::filesystem::file_time_type write_time;
+    int HZ;
+
+    bool operator==(const Key &other) const;
+  };
+
+  FrameStore(const Key &key, const std::string &raw_bin_path);
+  void _transform();
+
+private:
+  Key _key;
+  std::string _raw_bin_path;
+  int _HZ;
+  std::int64_t _line_num = 0;    // the log may have more than 2^31 points
+  bool _is_xydata = false;
+  std::once_flag _transform_flag;
+
+  std::mutex _cache_mutex;
+  std::vector<std::shared_ptr<const FrameData>> _cache;    // a ring of the latest segmented frames
+  int _cache_next = 0;
+};
+
+#endif
@@ -0,0 +1,58 @@
+/**
+ * @file RenderBuffer.cpp
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The implementation of the render buffer of the segments in a frame
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Mes
+ *
+ */
+
+#include "RenderBuffer.h"
+
+#include <algorithm>
+#include <iterator>
+
+/**
+ * @brief Regroup the points if the frame or the classes changed, otherwise do nothing.
+ *
+ * @param segment_vec The segments of the frame, the x and y of the points are the first two columns.
+ * @param class_vec The class of each segment, in [0, CLASS_NUM).
+ * @return true if it's rebuilt.
+ */
+bool RenderBuffer::update(const std::vector<Eigen::MatrixXd> &segment_vec, const std::vector<int> &class_vec)
+{
+  if (!_stale && class_vec == _class_vec)
+    return false;
+
+  _stale = false;
+  _class_vec = class_vec;
+
+  // count the points of each class, then place the points class by class
+  std::fill(std::begin(_class_start), std::end(_class_start), 0);
+  for (int i = 0; i < static_cast<int>(segment_vec.size()); ++i)
+    _class_start[class_vec[i] + 1] += static_cast<int>(segment_vec[i].rows());
+
+  for (int c = 1; c <= CLASS_NUM; ++c)
+    _class_start[c] += _class_start[c - 1];
+
+  int fill_pos[CLASS_NUM];
+  std::copy(std::begin(_class_start), std::end(_class_start) - 1, fill_pos);
+
+  _x_vec.resize(_class_start[CLASS_NUM]);
+  _y_vec.resize(_class_start[CLASS_NUM]);
+  _mean_vec.resize(segment_vec.size());
+  for (int i = 0; i < static_cast<int>(segment_vec.size()); ++i) {
+    const Eigen::MatrixXd &segment = segment_vec[i];
+    const int rows = static_cast<int>(segment.rows());
+
+    Eigen::Map<Eigen::VectorXd>(_x_vec.data() + fill_pos[class_vec[i]], rows) = segment.col(0);
+    Eigen::Map<Eigen::VectorXd>(_y_vec.data() + fill_pos[class_vec[i]], rows) = segment.col(1);
+    fill_pos[class_vec[i]] += rows;
+
+    _mean_vec[i] = segment.leftCols(2).colwise().mean().transpose();
+  }
+
+  return true;
+}
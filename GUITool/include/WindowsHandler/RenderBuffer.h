@@ -0,0 +1,51 @@
+/**
+ * @file RenderBuffer.h
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The declaration of the render buffer of the segments in a frame
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Mes
+ *
+ */
+
+#ifndef RENDER_BUFFER_H__
+#define RENDER_BUFFER_H__
+
+#include "Eigen/Eigen"
+
+#include <vector>
+
+/**
+ * @brief The points of the segments grouped by the class (the color) of the segment, the x and y of a class are contiguous,
+ *        thus a frame is drawn by one `PlotScatter` per class instead of one per segment.
+ *        It's rebuilt only when the frame or the classes of the segments change.
+ */
+class RenderBuffer {
+public:
+  bool update(const std::vector<Eigen::MatrixXd> &segment_vec, const std::vector<int> &class_vec);
+  void invalidate() { _stale = true; }
+
+  const double *x(const int class_index) const { return _x_vec.data() + _class_start[class_index]; }
+  const double *y(const int class_index) const { return _y_vec.data() + _class_start[class_index]; }
+  int size(const int class_index) const { return _class_start[class_index + 1] - _class_start[class_index]; }
+
+  double mean_x(const int segment) const { return _mean_vec[segment].x(); }    // the mean of the segment, computed when it's built
+  double mean_y(const int segment) const { return _mean_vec[segment].y(); }
+
+public:
+  static constexpr int COLOR_CLASS_NUM = 9;    // the normal segment i is in the class i % 9
+  static constexpr int TARGET_CLASS = COLOR_CLASS_NUM;    // the labeled (or predicted) target segments
+  static constexpr int CLASS_NUM = COLOR_CLASS_NUM + 1;
+
+private:
+  std::vector<double> _x_vec;    // the x of the points, sorted by the class
+  std::vector<double> _y_vec;
+  int _class_start[CLASS_NUM + 1] = {};    // the first point of each class, with one more for the end
+
+  std::vector<int> _class_vec;    // the class of each segment in the buffer
+  std::vector<Eigen::Vector2d> _mean_vec;
+  bool _stale = true;
+};
+
+#endif
@@ -11,9 +11,136 @@
 
 #include "imgui_header.h"
 #include "show_control_window.h"
+#include "profiler.h"
+#include "task_scheduler.h"
 
+#include <algorithm>
 #include <iostream>
 
+namespace {
+  constexpr int TASK_POOL_HISTORY_SIZE = 256;    // the GUI frames kept in the history of the task pool
+
+  float task_pool_utilization[TASK_POOL_HISTORY_SIZE] = {};    // the busy time over the wall time of all the threads, in percent
+  float task_pool_queue_depth[TASK_POOL_HISTORY_SIZE] = {};
+  int task_pool_history_size = 0, task_pool_history_offset = 0;
+}    // namespace
+
+/**
+ * @brief Sample the task pool once per frame, the utilization is the busy time of the tasks since the last sample.
+ */
+static void SampleTaskPool()
+{
+  static double last_time = -1, last_busy_seconds = 0;
+
+  const TaskSchedulerStats stats = TaskScheduler::instance().stats();
+  const double time = ImGui::GetTime();
+  if (last_time >= 0 && time > last_time) {
+    const double utilization = (stats.busy_seconds - last_busy_seconds) / ((time - last_time) * stats.thread_num);
+
+    const int i = (task_pool_history_offset + task_pool_history_size) % TASK_POOL_HISTORY_SIZE;
+    task_pool_utilization[i] = static_cast<float>(std::clamp(utilization, 0.0, 1.0) * 100);
+    task_pool_queue_depth[i] = static_cast<float>(stats.queue_depth);
+    if (task_pool_history_size < TASK_POOL_HISTORY_SIZE)
+      ++task_pool_history_size;
+    else
+      task_pool_history_offset = (task_pool_history_offset + 1) % TASK_POOL_HISTORY_SIZE;
+  }
+
+  last_time = time;
+  last_busy_seconds = stats.busy_seconds;
+}
+
+/**
+ * @brief Show the threads, the queued tasks and the utilization of the shared task pool.
+ */
+static void ShowTaskPool()
+{
+  const TaskSchedulerStats stats = TaskScheduler::instance().stats();
+  ImGui::Text("Task Pool: %d threads, %d queued, %d running", stats.thread_num, stats.queue_depth, stats.active_num);
+
+  if (ImPlot::BeginPlot("Task Pool", ImVec2(-1, 200))) {
+    ImPlot::SetupAxes("frame", "", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+    if (task_pool_history_size != 0) {
+      ImPlot::PlotLine("utilization (%)", task_pool_utilization, task_pool_history_size, 1, 0, 0, task_pool_history_offset);
+      ImPlot::PlotLine("queue depth", task_pool_queue_depth, task_pool_history_size, 1, 0, 0, task_pool_history_offset);
+    }
+
+    ImPlot::EndPlot();
+  }
+}
+
+/**
+ * @brief Show the rolling latency of each pipeline stage, the samples are collected from all threads once per frame.
+ */
+void ShowProfiler()
+{
+  Profiler &profiler = Profiler::instance();
+  profiler.collect();
+  SampleTaskPool();
+
+  if (!ImGui::TreeNodeEx("Profiler"))
+    return;
+
+  bool enabled = profiler.enabled;
+  if (ImGui::Checkbox("Enable Profiling", &enabled))
+    profiler.enabled = enabled;
+
+  // the latest, p50 and p99 latency of each stage in the last samples
+  if (ImGui::BeginTable("profiler_table", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+    ImGui::TableSetupColumn("Stage");
+    ImGui::TableSetupColumn("Last (ms)");
+    ImGui::TableSetupColumn("p50 (ms)");
+    ImGui::TableSetupColumn("p99 (ms)");
+    ImGui::TableSetupColumn("Count");
+    ImGui::TableHeadersRow();
+
+    for (int i = 0; i < PROFILE_STAGE_NUM; ++i) {
+      const ProfileStage stage = static_cast<ProfileStage>(i);
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(PROFILE_STAGE_NAME[i]);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.3f", profiler.last(stage));
+      ImGui::TableNextColumn();
+      ImGui::Text("%.3f", profiler.p50(stage));
+      ImGui::TableNextColumn();
+      ImGui::Text("%.3f", profiler.p99(stage));
+      ImGui::TableNextColumn();
+      ImGui::Text("%llu", static_cast<unsigned long long>(profiler.count(stage)));
+    }
+
+    ImGui::EndTable();
+  }
+
+  // the rolling latency, the history of a stage is a ring, thus it's plotted from the offset of the oldest sample
+  if (ImPlot::BeginPlot("Stage Latency", ImVec2(-1, 250))) {
+    ImPlot::SetupAxes("sample", "ms", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+    for (int i = 0; i < PROFILE_STAGE_NUM; ++i) {
+      const ProfileStage stage = static_cast<ProfileStage>(i);
+      if (profiler.history_size(stage) != 0)
+        ImPlot::PlotLine(PROFILE_STAGE_NAME[i], profiler.history(stage), profiler.history_size(stage), 1, 0, 0, profiler.history_offset(stage));
+    }
+
+    ImPlot::EndPlot();
+  }
+
+  // the latency histogram of the selected stage
+  static int histogram_stage = 0;
+  ImGui::Combo("Histogram Stage", &histogram_stage, PROFILE_STAGE_NAME, PROFILE_STAGE_NUM);
+  if (ImPlot::BeginPlot("Latency Histogram", ImVec2(-1, 200))) {
+    ImPlot::SetupAxes("ms", "count", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+    const ProfileStage stage = static_cast<ProfileStage>(histogram_stage);
+    if (profiler.history_size(stage) != 0)
+      ImPlot::PlotHistogram(PROFILE_STAGE_NAME[histogram_stage], profiler.history(stage), profiler.history_size(stage), 32);
+
+    ImPlot::EndPlot();
+  }
+
+  ShowTaskPool();
+
+  ImGui::TreePop();
+}
+
 /**
  * @brief Show the control window, which can show the label window and simulation window
  *
@@ -26,5 +153,6 @@ void ShowControlWindow(bool &show_label_window, bool &show_simulation_window)
   ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
   ImGui::Checkbox("Show Label window", &show_label_window);
   ImGui::Checkbox("Show Simulation window", &show_simulation_window);
+  ShowProfiler();
   ImGui::End();
 }
\ No newline at end of file
@@ -11,6 +11,7 @@
 
 #include "imgui_header.h"
 #include "Controller.h"
+#include "profiler.h"
 #include "show_control_window.h"
 #include "show_label_window.h"
 #include "show_simulation_window.h"
@@ -21,10 +22,15 @@
 #endif
 #include <GLFW/glfw3.h>    // Will drag system OpenGL headers
 
+#include <chrono>
+#include <iostream>
+
 #if defined(_MSC_VER) && (_MSC_VER >= 1900) && !defined(IMGUI_DISABLE_WIN32_FUNCTIONS)
 #pragma comment(lib, "legacy_stdio_definitions")
 #endif
 
+static const auto process_start_time = std::chrono::steady_clock::now();    // for the time to the first frame
+
 static void glfw_error_callback(int error, const char *description)
 {
   fprintf(stderr, "Glfw Error %d: %s\n", error, description);
@@ -32,6 +38,8 @@ static void glfw_error_callback(int error, const char *description)
 
 int main(int, char **)
 {
+  Profiler::instance().enabled = true;    // the control window collects the samples
+
   glfwSetErrorCallback(glfw_error_callback);
   if (!glfwInit())
     return 1;
@@ -85,6 +93,7 @@ int main(int, char **)
 
   bool show_label_window = true;
   bool show_simulation_window = true;
+  bool first_frame = true;
 
   /*-----------------------------------------------------------------------------------------------------*/
 
@@ -112,6 +121,12 @@ int main(int, char **)
     glClear(GL_COLOR_BUFFER_BIT);
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
     glfwSwapBuffers(window);
+
+    // the controllers are loaded in the background, thus the first frame only waits for the window
+    if (first_frame) {
+      first_frame = false;
+      std::cout << "first frame in " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - process_start_time).count() << " ms\n";
+    }
   }
 
   // Cleanup
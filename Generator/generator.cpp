@@ -0,0 +1,244 @@
+/**
+ * @file generator.cpp
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief Generate a synthetic raw log in the format `transform_frame` reads, with the ground truth labels, for testing the tools at a large scale.
+ *        It writes <output>.txt (the raw log) and <output>_point_label.bin (a byte per line of the log, 1 if the point is on a ball),
+ *        and with `--dataset`, <output>_feature.txt and <output>_label.txt in the format of the demo data (a row per segment).
+ *        Execute it by `Generator --output <path without extension> [options]`, the options are listed by `Generator --help`.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "scan_generator.h"
+#include "make_feature.h"
+#include "metric.h"
+#include "task_scheduler.h"
+#include "Eigen/Eigen"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+constexpr int CHUNK_FRAME_NUM = 64;    // the numbers of the frames generated by a task
+
+/**
+ * @brief The generated frames [begin, end).
+ */
+struct GeneratedChunk {
+  std::string raw_text;
+  std::vector<std::uint8_t> point_label;
+  std::string feature_text;
+  std::string label_text;
+  std::int64_t segment_num = 0;
+  std::int64_t target_segment_num = 0;
+};
+
+/**
+ * @brief Append the number as `operator<<` with the default format does, i.e. %g with 6 significant digits.
+ */
+static void append_number(std::string &text, const double number)
+{
+  std::array<char, 32> number_buffer;
+  char *end = std::to_chars(number_buffer.data(), number_buffer.data() + number_buffer.size(), number, std::chars_format::general, 6).ptr;
+  text.append(number_buffer.data(), end);
+}
+
+/**
+ * @brief Generate the frames [begin, end), and segment them as the label tool does if the dataset is needed.
+ *        A segment is labeled as the target if most of its points are on a ball.
+ */
+static GeneratedChunk generate_chunk(const ScanGenerator &generator, const int begin, const int end, const bool make_dataset)
+{
+  const int HZ = generator.scene().HZ;
+
+  GeneratedChunk chunk;
+  chunk.raw_text.reserve(static_cast<std::size_t>(end - begin) * HZ * 24);
+  chunk.point_label.reserve(static_cast<std::size_t>(end - begin) * HZ);
+
+  Eigen::MatrixXd raw_data, xy_data;
+  std::vector<std::uint8_t> frame_label;
+  for (int f = begin; f < end; ++f) {
+    generator.make_frame(f, raw_data, frame_label);
+    ScanGenerator::append_raw_text(raw_data, chunk.raw_text);
+    chunk.point_label.insert(chunk.point_label.end(), frame_label.begin(), frame_label.end());
+
+    if (!make_dataset)
+      continue;
+
+    xy_data = raw_data;
+    if (generator.scene().rtheta)
+      metric::rtheta_to_xy(xy_data, HZ);
+
+    const auto [feature_matrix, segment_vec] = MakeFeatures::section_to_feature(xy_data);
+    for (int s = 0; s < static_cast<int>(segment_vec.size()); ++s) {
+      const Eigen::MatrixXd &segment = segment_vec[s];
+      int on_ball_num = 0;
+      for (int p = 0; p < segment.rows(); ++p)
+        on_ball_num += generator.on_ball(f, segment(p, 0), segment(p, 1));
+
+      const bool target = on_ball_num * 2 > segment.rows();
+      for (int c = 0; c < FEATURE_NUM; ++c) {
+        append_number(chunk.feature_text, feature_matrix(s, c));
+        chunk.feature_text += " \n"[c == FEATURE_NUM - 1];
+      }
+      chunk.label_text += target ? "1\n" : "0\n";
+      chunk.target_segment_num += target;
+    }
+    chunk.segment_num += segment_vec.size();
+  }
+
+  return chunk;
+}
+
+static void print_usage(const char *program)
+{
+  std::cerr << "usage: " << program << " --output <path without extension> [options]\n"
+            << "  --frames <n>       the frames, default 1000\n"
+            << "  --hz <n>           the points of a frame, default 360\n"
+            << "  --rtheta           write [theta r] lines (the HZ must be 360 or 720), otherwise [x y] lines\n"
+            << "  --room <x> <y>     the half size of the room, 0 for no walls, default 3 2\n"
+            << "  --balls <n>        the balls, default 3\n"
+            << "  --radius <m>       the radius of the balls, default 0.1\n"
+            << "  --clutter <n>      the static boxes, default 4\n"
+            << "  --noise <m>        the standard deviation of the range noise, default 0.005\n"
+            << "  --nan <p>          the probability of a NaN return, default 0\n"
+            << "  --zero <p>         the probability of a zero return, default 0\n"
+            << "  --seed <n>         the seed of the scene, default 1\n"
+            << "  --threads <n>      the threads of the task pool, default all the cores\n"
+            << "  --dataset          also write the features and the labels of the segments\n";
+}
+
+int main(int argc, char *argv[])
+{
+  ScanScene scene;
+  std::string output_path;
+  int frame_num = 1000;
+  int thread_num = 0;    // the default threads of the pool
+  bool make_dataset = false;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const int value_num = (arg == "--rtheta" || arg == "--dataset" || arg == "--help") ? 0 : (arg == "--room" ? 2 : 1);
+    if (i + value_num >= argc) {
+      print_usage(argv[0]);
+      return 1;
+    }
+
+    if (arg == "--output")
+      output_path = argv[++i];
+    else if (arg == "--frames")
+      frame_num = std::stoi(argv[++i]);
+    else if (arg == "--hz")
+      scene.HZ = std::stoi(argv[++i]);
+    else if (arg == "--rtheta")
+      scene.rtheta = true;
+    else if (arg == "--room") {
+      scene.room_half_x = std::stod(argv[++i]);
+      scene.room_half_y = std::stod(argv[++i]);
+    }
+    else if (arg == "--balls")
+      scene.ball_num = std::stoi(argv[++i]);
+    else if (arg == "--radius")
+      scene.ball_radius = std::stod(argv[++i]);
+    else if (arg == "--clutter")
+      scene.clutter_num = std::stoi(argv[++i]);
+    else if (arg == "--noise")
+      scene.noise = std::stod(argv[++i]);
+    else if (arg == "--nan")
+      scene.nan_rate = std::stod(argv[++i]);
+    else if (arg == "--zero")
+      scene.zero_rate = std::stod(argv[++i]);
+    else if (arg == "--seed")
+      scene.seed = std::stoull(argv[++i]);
+    else if (arg == "--threads")
+      thread_num = std::max(1, std::stoi(argv[++i]));
+    else if (arg == "--dataset")
+      make_dataset = true;
+    else {
+      print_usage(argv[0]);
+      return arg == "--help" ? 0 : 1;
+    }
+  }
+
+  if (output_path.empty() || frame_num <= 0 || scene.HZ <= 0) {
+    print_usage(argv[0]);
+    return 1;
+  }
+  if (scene.rtheta && scene.HZ != 360 && scene.HZ != 720) {
+    std::cerr << "the [theta r] log needs a 1 or 0.5 degree step, thus the HZ must be 360 or 720, but it's " << scene.HZ << '\n';
+    return 1;
+  }
+
+  if (thread_num > 0)
+    TaskScheduler::set_thread_num(thread_num);
+  TaskScheduler &scheduler = TaskScheduler::instance();
+  const int wave_frame_num = scheduler.thread_num() * CHUNK_FRAME_NUM;
+
+  const ScanGenerator generator(scene);
+  const std::string raw_path = output_path + ".txt";
+  const std::string point_label_path = output_path + "_point_label.bin";
+  const std::string feature_path = output_path + "_feature.txt";
+  const std::string label_path = output_path + "_label.txt";
+
+  std::ofstream raw_file(raw_path, std::ios::binary | std::ios::trunc);
+  std::ofstream point_label_file(point_label_path, std::ios::binary | std::ios::trunc);
+  std::ofstream feature_file, label_file;
+  if (make_dataset) {
+    feature_file.open(feature_path, std::ios::binary | std::ios::trunc);
+    label_file.open(label_path, std::ios::binary | std::ios::trunc);
+  }
+
+  for (const std::ofstream *outfile : { &raw_file, &point_label_file }) {
+    if (outfile->fail()) {
+      std::cerr << "cant open " << output_path << "*\n";
+      std::cin.get();
+      exit(1);
+    }
+  }
+  if (make_dataset && (feature_file.fail() || label_file.fail())) {
+    std::cerr << "cant open " << feature_path << " or " << label_path << '\n';
+    std::cin.get();
+    exit(1);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  std::int64_t segment_num = 0, target_segment_num = 0, raw_bytes = 0;
+
+  // generate a wave of chunks in parallel, then write them in order
+  std::vector<GeneratedChunk> chunk_vec;
+  for (int wave_begin = 0; wave_begin < frame_num; wave_begin += wave_frame_num) {
+    const int wave_end = std::min(frame_num, wave_begin + wave_frame_num);
+    chunk_vec.assign((wave_end - wave_begin + CHUNK_FRAME_NUM - 1) / CHUNK_FRAME_NUM, GeneratedChunk());
+    scheduler.parallel_for(wave_begin, wave_end, CHUNK_FRAME_NUM, [&](const int begin, const int end) {
+      chunk_vec[(begin - wave_begin) / CHUNK_FRAME_NUM] = generate_chunk(generator, begin, end, make_dataset);
+    });
+
+    for (const GeneratedChunk &chunk : chunk_vec) {
+      raw_file.write(chunk.raw_text.data(), chunk.raw_text.size());
+      point_label_file.write(reinterpret_cast<const char *>(chunk.point_label.data()), chunk.point_label.size());
+      raw_bytes += chunk.raw_text.size();
+
+      if (make_dataset) {
+        feature_file.write(chunk.feature_text.data(), chunk.feature_text.size());
+        label_file.write(chunk.label_text.data(), chunk.label_text.size());
+        segment_num += chunk.segment_num;
+        target_segment_num += chunk.target_segment_num;
+      }
+    }
+
+    std::cout << "\rGenerated frames: " << wave_end << '/' << frame_num << std::flush;
+  }
+
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::cout << "\nwrote " << raw_path << " (" << static_cast<std::int64_t>(frame_num) * scene.HZ << " lines, " << raw_bytes / (1 << 20) << " MiB) and "
+            << point_label_path << '\n';
+  if (make_dataset)
+    std::cout << "wrote " << feature_path << " and " << label_path << " (" << segment_num << " segments, " << target_segment_num << " targets)\n";
+  std::cout << frame_num << " frames with " << scheduler.thread_num() << " threads in " << seconds << " s (" << frame_num / std::max(seconds, 1e-9) << " frames/s)\n";
+}
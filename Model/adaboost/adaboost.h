@@ -10,9 +10,16 @@
  */
 
 #include "normalize.h"
+#include "dataset.h"
+#include "trace.h"
 #include "Eigen/Eigen"
 
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <cmath>
 #include <iostream>
@@ -27,20 +34,29 @@
  * @param ins The instance of the class.
  */
 template <typename Model>
-concept has_fit = requires(Model ins, const Eigen::MatrixXd &train_X, const Eigen::VectorXd &train_Y, const Eigen::MatrixXd &train_weight, uint32_t Iterations) {
+concept has_fit = requires(Model ins, const Eigen::MatrixXd &train_X, const Eigen::VectorXd &train_Y, const Dataset &train, const Eigen::MatrixXd &train_weight, uint32_t Iterations) {
   {
     ins.fit(train_X, train_Y, train_weight, Iterations)
   } -> std::same_as<std::tuple<Eigen::VectorXd, double, bool>>;
+  {
+    ins.fit(train, train_weight, Iterations)
+  } -> std::same_as<std::tuple<Eigen::VectorXd, double, bool>>;    // the rounds train on the views of the rows
 };
 
 /**
  * @param ins The instance of the class.
  */
 template <typename Model>
-concept has_predict = requires(Model ins, const Eigen::MatrixXd &section) {
+concept has_predict = requires(const Model ins, const Eigen::MatrixXd &section, const Dataset &data) {
   {
     ins.predict(section)
   } -> std::same_as<Eigen::VectorXd>;
+  {
+    ins.get_label(section)
+  } -> std::same_as<Eigen::VectorXd>;
+  {
+    ins.get_label(data)
+  } -> std::same_as<Eigen::VectorXd>;    // the validation of the rounds is on a view of the rows
 };
 
 template <typename Module>
@@ -56,14 +72,10 @@ template <typename, typename = void>
 struct has_fit : std::false_type {};
 
 template <typename Model>
-struct has_fit<Model, std::void_t<decltype(&Model::fit)>>
-    : std::is_invocable_r<std::tuple<Eigen::VectorXd, double, bool>,
-                          decltype(&Model::fit),
-                          Model &,
-                          const Eigen::MatrixXd &,
-                          const Eigen::VectorXd &,
-                          const Eigen::MatrixXd &,
-                          int> {};
+struct has_fit<Model, std::void_t<decltype(std::declval<Model &>().fit(std::declval<const Eigen::MatrixXd &>(), std::declval<const Eigen::VectorXd &>(),
+                                                                       std::declval<const Eigen::MatrixXd &>(), uint32_t{})),
+                                  decltype(std::declval<Model &>().fit(std::declval<const Dataset &>(), std::declval<const Eigen::MatrixXd &>(), uint32_t{}))>>
+    : std::true_type {};
 
 /**
  * @brief Check if the class has `predict` function.
@@ -72,11 +84,10 @@ template <typename, typename = void>
 struct has_predict : std::false_type {};
 
 template <typename Model>
-struct has_predict<Model, std::void_t<decltype(&Model::predict)>>
-    : std::is_invocable_r<Eigen::VectorXd,
-                          decltype(&Model::predict),
-                          Model &,
-                          const Eigen::MatrixXd &> {};
+struct has_predict<Model, std::void_t<decltype(std::declval<const Model &>().predict(std::declval<const Eigen::MatrixXd &>())),
+                                      decltype(std::declval<const Model &>().get_label(std::declval<const Eigen::MatrixXd &>())),
+                                      decltype(std::declval<const Model &>().get_label(std::declval<const Dataset &>()))>>
+    : std::true_type {};
 
 template <typename Model>
 struct valid_Model : std::conjunction<has_fit<Model>, has_predict<Model>> {};
@@ -86,6 +97,15 @@ constexpr bool valid_Model_v = valid_Model<Model>::value;
 
 #endif
 
+/**
+ * @brief Check if the weak learner reports the passes over the training data used by its last fit.
+ */
+template <typename, typename = void>
+struct has_passes : std::false_type {};
+
+template <typename Model>
+struct has_passes<Model, std::void_t<decltype(std::declval<Model &>().passes)>> : std::true_type {};
+
 
 /**
  * @brief The Adaboost class, have M weak classfiers, each weak classfiers is a logistic regression classifier.
@@ -105,6 +125,14 @@ public:
   int M = 0;    // the number of weak classfiers
   Eigen::VectorXd alpha;    // the vector of weights for weak classfiers
 
+  uint32_t learner_passes = 1000;    // the iterations (or the epochs) of each weak classfier
+  std::int64_t max_total_passes = 0;    // the passes over the training data of all the rounds, no limit if it's 0
+  std::int64_t total_passes = 0;    // the passes used by the last fit
+
+  int early_stop_rounds = 10;    // stop if the validation F1 Score isn't improved in these rounds, no early stopping if it's 0
+  int rounds_trained = 0;    // the rounds trained before the early stopping and the pruning dropped the weak classfiers
+  bool print_progress = true;    // print the round in training, off if several Adaboosts are trained at once
+
   std::vector<Model> vec;    // the vector of weak classfiers
 
 public:
@@ -118,15 +146,139 @@ public:
    * @param train_X The training data, which is a feature matrix.
    * @param train_Y The training label.
    */
-  void fit(const Eigen::MatrixXd &train_X, const Eigen::VectorXd &train_Y)    // training Adaboost
+  void fit(const Eigen::Ref<const Eigen::MatrixXd> &train_X, const Eigen::Ref<const Eigen::VectorXd> &train_Y)    // training Adaboost
+  {
+    _fit(Dataset(train_X, train_Y), nullptr);
+  }
+
+  /**
+   * @brief Training Adaboost on the rows of the view, e.g. a fold or a bootstrap sample, the rows are not copied.
+   *
+   * @param train The training data and label.
+   */
+  void fit(const Dataset &train)
   {
-    Eigen::VectorXd w = Eigen::VectorXd::Ones(train_X.rows());
+    _fit(train, nullptr);
+  }
+
+  /**
+   * @brief Training Adaboost, the F1 Score of the validation data is updated after each round,
+   *        the training stops if it isn't improved in `early_stop_rounds` rounds, then the rounds after the best one are dropped.
+   *
+   * @param train_X The training data, which is a feature matrix.
+   * @param train_Y The training label.
+   * @param valid_X The validation data, which is a feature matrix.
+   * @param valid_Y The validation label.
+   */
+  void fit(const Eigen::Ref<const Eigen::MatrixXd> &train_X, const Eigen::Ref<const Eigen::VectorXd> &train_Y, const Eigen::Ref<const Eigen::MatrixXd> &valid_X, const Eigen::Ref<const Eigen::VectorXd> &valid_Y)
+  {
+    const Dataset valid(valid_X, valid_Y);
+    _fit(Dataset(train_X, train_Y), &valid);
+  }
+
+  void fit(const Dataset &train, const Dataset &valid)
+  {
+    _fit(train, &valid);
+  }
+
+  /**
+   * @brief Drop the weak classfiers whose removal doesn't lower the F1 Score of the validation data, the least weighted one is tried first.
+   *
+   * @param valid_X The validation data, which is a feature matrix.
+   * @param valid_Y The validation label.
+   * @return int The number of the dropped weak classfiers.
+   */
+  int prune(const Eigen::Ref<const Eigen::MatrixXd> &valid_X, const Eigen::Ref<const Eigen::VectorXd> &valid_Y)
+  {
+    return prune(Dataset(valid_X, valid_Y));
+  }
+
+  int prune(const Dataset &valid)
+  {
+    MRL_TRACE_SCOPE("Adaboost::prune");
+
+    // the votes of each weak classfier are computed once, thus a removal is checked by a subtraction
+    Eigen::MatrixXd votes(valid.rows(), M);
+    valid.for_each_block([&](const int begin, const auto &X, const auto &) {
+      for (int m = 0; m < M; ++m)
+        votes.col(m).segment(begin, X.rows()) = alpha(m) * (2 * vec[m].get_label(X).array() - 1).matrix();
+    });
+
+    Eigen::ArrayXd C = votes.rowwise().sum().array();
+    double F1_Score = _F1_score(valid, C);
+
+    std::vector<int> order(M);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](const int a, const int b) { return std::abs(alpha(a)) < std::abs(alpha(b)); });
+
+    std::vector<bool> keep(M, true);
+    int keep_num = M;
+    for (const int m : order) {
+      if (keep_num == 1)
+        break;
+
+      const Eigen::ArrayXd pruned_C = C - votes.col(m).array();
+      const double pruned_F1_Score = _F1_score(valid, pruned_C);
+      if (pruned_F1_Score >= F1_Score) {
+        C = pruned_C;
+        F1_Score = pruned_F1_Score;
+        keep[m] = false;
+        --keep_num;
+      }
+    }
+
+    const int pruned_num = M - keep_num;
+    std::vector<Model> kept_vec;
+    Eigen::VectorXd kept_alpha(keep_num);
+    for (int m = 0; m < M; ++m) {
+      if (keep[m]) {
+        kept_alpha(kept_vec.size()) = alpha(m);
+        kept_vec.push_back(std::move(vec[m]));
+      }
+    }
+
+    vec = std::move(kept_vec);
+    alpha = std::move(kept_alpha);
+    M = keep_num;
+    return pruned_num;
+  }
+
+private:
+  void _fit(const Dataset &train, const Dataset *valid)
+  {
+    Eigen::VectorXd w = Eigen::VectorXd::Ones(train.rows());
+    total_passes = 0;
+
+    // the votes of the trained rounds on the validation data, each round adds its own votes
+    Eigen::ArrayXd valid_C;
+    if (valid != nullptr)
+      valid_C = Eigen::ArrayXd::Zero(valid->rows());
+    double best_F1_Score = -1.0;
+    int best_M = M;
 
     for (int i = 0; i < M; ++i) {
-      std::cout << "\rTraining Weak Learner: " << i + 1 << std::flush;
+      MRL_TRACE_SCOPE("Adaboost::fit round");
+
+      // the rounds after the budget of the passes is used up are dropped
+      uint32_t Iterations = learner_passes;
+      if (max_total_passes > 0) {
+        if (total_passes >= max_total_passes) {
+          _truncate(i);
+          break;
+        }
+
+        Iterations = static_cast<uint32_t>(std::min<std::int64_t>(Iterations, max_total_passes - total_passes));
+      }
+
+      if (print_progress)
+        std::cout << "\rTraining Weak Learner: " << i + 1 << std::flush;
       w /= w.sum();
 
-      const auto [pred_Y, err, all_correct] = vec[i].fit(train_X, train_Y, w, 1000);    // pred_Y is the label it predict, err is the error rate.
+      const auto [pred_Y, err, all_correct] = vec[i].fit(train, w, Iterations);    // pred_Y is the label it predict, err is the error rate.
+      if constexpr (has_passes<Model>::value)
+        total_passes += vec[i].passes;
+      else
+        total_passes += Iterations;
 
       // if the accuracy is 100%, we can delete all the other weak learner in adaboost, just use this weak learner to judge data.
       if (all_correct) {
@@ -135,32 +287,91 @@ public:
         vec.push_back(std::move(tmp));
         M = 1;
         alpha = Eigen::VectorXd::Ones(M);
+        best_M = 1;
         break;
       }
 
       alpha(i) = std::log((1 + err) / (1 - err)) / 2;
-      for (int r = 0; r < train_Y.size(); ++r) {
-        if (train_Y(r) != pred_Y(r))
+      for (int r = 0; r < train.rows(); ++r) {
+        if (train.label(r) != pred_Y(r))
           w(r) *= std::exp(alpha(i));
         else
           w(r) *= std::exp(-alpha(i));
       }
+
+      if (valid != nullptr) {
+        valid_C += alpha(i) * (2 * vec[i].get_label(*valid).array() - 1);
+
+        const double F1_Score = _F1_score(*valid, valid_C);
+        if (F1_Score > best_F1_Score) {
+          best_F1_Score = F1_Score;
+          best_M = i + 1;
+        }
+        else if (early_stop_rounds > 0 && i + 1 - best_M >= early_stop_rounds) {
+          _truncate(i + 1);
+          break;
+        }
+      }
+    }
+
+    rounds_trained = M;
+    if (valid != nullptr && best_M < M)
+      _truncate(best_M);
+  }
+
+  /**
+   * @brief Keep the first `n` weak classfiers.
+   */
+  void _truncate(const int n)
+  {
+    M = n;
+    vec.resize(M);
+    alpha.conservativeResize(M);
+  }
+
+  /**
+   * @brief The F1 Score of the votes, the segment is predicted as an object if its vote is positive.
+   */
+  static double _F1_score(const Dataset &data, const Eigen::ArrayXd &C)
+  {
+    int TP{}, FP{}, FN{};
+    for (int i = 0; i < data.rows(); ++i) {
+      const bool pred = C(i) > 0;
+      const double y = data.label(i);
+      TP += pred && y == 1;
+      FP += pred && y == 0;
+      FN += !pred && y == 1;
     }
+
+    return TP == 0 ? 0.0 : 2.0 * TP / (2.0 * TP + FP + FN);
   }
 
+public:
   /**
    * @brief Make the prediction of the data.
    *
    * @param data The data need to be predicted, which is a feature matrix.
    * @return Eigen::VectorXd The output label vector.
    */
-  Eigen::VectorXd predict(const Eigen::MatrixXd &data)    // make prediction
+  Eigen::VectorXd predict(const Eigen::Ref<const Eigen::MatrixXd> &data)    // make prediction
   {
+    return predict(Dataset(data));
+  }
+
+  /**
+   * @brief Make the prediction of the rows of the view, a gathered block is read by all the weak classfiers.
+   */
+  Eigen::VectorXd predict(const Dataset &data)
+  {
+    MRL_TRACE_SCOPE("Adaboost::predict");
+
     int R = data.rows();
     Eigen::ArrayXd C = Eigen::ArrayXd::Zero(R);
 
-    for (int m = 0; m < M; ++m)
-      C += alpha(m) * (2 * vec[m].get_label(data).array() - 1);
+    data.for_each_block([&](const int begin, const auto &X, const auto &) {
+      for (int m = 0; m < M; ++m)
+        C.segment(begin, X.rows()) += alpha(m) * (2 * vec[m].get_label(X).array() - 1);
+    });
 
     return C.unaryExpr([](double x) { return double(x > 0); });
   }
@@ -179,7 +390,7 @@ public:
     double F1_Score = 2 * precision * recall / (precision + recall);
 
     outfile << F1_Score << ' ' << TN << ' ' << TP << ' ' << FN << ' ' << FP << '\n';
-    outfile << M << '\n';
+    outfile << M << ' ' << rounds_trained << '\n';
     for (int i = 0; i < M; ++i)
       outfile << alpha(i) << " \n"[i == M - 1];
 
@@ -210,6 +421,8 @@ public:
     getline(infile, line);
     stream << line;
     stream >> M;
+    if (!(stream >> rounds_trained))    // the weight files stored before the early stopping only have M
+      rounds_trained = M;
     stream.str("");
     stream.clear();
 
@@ -0,0 +1,163 @@
+/**
+ * @file cross_validation.cpp
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The implementation of the k-fold cross-validation and the hyperparameter sweep.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "cross_validation.h"
+#include "adaboost.h"
+#include "logistic.h"
+#include "metric.h"
+#include "task_scheduler.h"
+#include "trace.h"
+#include "Eigen/Eigen"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <vector>
+
+/**
+ * @brief All the combinations of the values for the grid search, or `sample_num` of them without repetition for the random search.
+ */
+std::vector<SweepConfig> SweepSpec::configs() const
+{
+  std::vector<SweepConfig> config_vec;
+  for (const int r : rounds)
+    for (const uint32_t p : passes)
+      for (const double lr : learning_rate)
+        for (const int b : batch_size)
+          config_vec.push_back(SweepConfig{ r, p, lr, b });
+
+  if (random && sample_num < static_cast<int>(config_vec.size())) {
+    std::mt19937_64 gen(seed);
+    std::shuffle(config_vec.begin(), config_vec.end(), gen);
+    config_vec.resize(std::max(sample_num, 0));
+  }
+
+  return config_vec;
+}
+
+namespace {
+  /**
+   * @brief The scores of a configuration on a fold.
+   */
+  struct FoldScore {
+    double F1_Score = 0.0;
+    double accuracy = 0.0;
+    int M = 0;
+    double fit_seconds = 0.0;
+    double predict_seconds = 0.0;
+  };
+
+  FoldScore run_fold(const Dataset &data, const int fold_num, const SweepConfig &config, const int fold)
+  {
+    MRL_TRACE_SCOPE("CrossValidation fold");
+
+    Adaboost<logistic> A(config.rounds);
+    A.learner_passes = config.passes;
+    A.print_progress = false;
+    for (int m = 0; m < A.M; ++m) {
+      A.vec[m].learning_rate = config.learning_rate;
+      A.vec[m].sgd.learning_rate = config.learning_rate;
+      A.vec[m].sgd.batch_size = config.batch_size;
+      A.vec[m].init_seed = static_cast<std::uint64_t>(fold) * A.M + m + 1;    // the same result for any number of threads
+      A.vec[m].sgd.seed = A.vec[m].init_seed;
+    }
+
+    const auto [train, valid] = data.fold(fold, fold_num);
+
+    FoldScore score;
+    const auto fit_start = std::chrono::steady_clock::now();
+    A.fit(train);
+    const auto predict_start = std::chrono::steady_clock::now();
+    const Eigen::VectorXd pred_Y = A.predict(valid);
+    const auto predict_end = std::chrono::steady_clock::now();
+
+    const Eigen::MatrixXd confusion = metric::cal_confusion_matrix(valid, pred_Y);
+    const double TP = confusion(0, 0), FP = confusion(0, 1), FN = confusion(1, 0), TN = confusion(1, 1);
+
+    score.F1_Score = TP == 0 ? 0.0 : 2.0 * TP / (2.0 * TP + FP + FN);
+    score.accuracy = (TP + TN) / std::max(1, valid.rows());
+    score.M = A.M;
+    score.fit_seconds = std::chrono::duration<double>(predict_start - fit_start).count();
+    score.predict_seconds = std::chrono::duration<double>(predict_end - predict_start).count();
+    return score;
+  }
+}    // namespace
+
+namespace CrossValidation {
+  /**
+   * @brief Run a job for each fold of each configuration on the task pool, all the jobs read the same storage,
+   *        the training rows of a job are the row indices of its fold, the validation rows are a range of the view.
+   *        The jobs of the larger configurations are started first, thus a long job doesn't start at the end and run alone.
+   *
+   * @param data The shuffled rows of the dataset, the folds are its consecutive parts.
+   * @param fold_num The number of the folds.
+   * @param config_vec The configurations to try.
+   * @return std::vector<SweepResult> The results, from the best mean F1 Score to the worst one,
+   *         the faster configuration is the better one if their F1 Scores are the same.
+   */
+  std::vector<SweepResult> sweep(const Dataset &data, const int fold_num, const std::vector<SweepConfig> &config_vec)
+  {
+    const int job_num = static_cast<int>(config_vec.size()) * fold_num;
+    std::vector<FoldScore> score_vec(job_num);
+
+    std::vector<int> job_vec(job_num);
+    std::iota(job_vec.begin(), job_vec.end(), 0);
+    std::stable_sort(job_vec.begin(), job_vec.end(), [&](const int a, const int b) {
+      const SweepConfig &ca = config_vec[a / fold_num], &cb = config_vec[b / fold_num];
+      return static_cast<double>(ca.rounds) * ca.passes > static_cast<double>(cb.rounds) * cb.passes;
+    });
+
+    std::mutex print_mutex;
+    int done_num = 0;
+
+    TaskGroup group;
+    for (const int job : job_vec) {
+      group.run([&, job] {
+        score_vec[job] = run_fold(data, fold_num, config_vec[job / fold_num], job % fold_num);
+
+        std::lock_guard lock(print_mutex);
+        std::cout << "\rFinished folds: " << ++done_num << '/' << job_num << std::flush;
+      });
+    }
+    group.wait();
+    std::cout << '\n';
+
+    std::vector<SweepResult> result_vec(config_vec.size());
+    for (std::size_t c = 0; c < config_vec.size(); ++c) {
+      SweepResult &result = result_vec[c];
+      result.config = config_vec[c];
+
+      for (int k = 0; k < fold_num; ++k) {
+        const FoldScore &score = score_vec[c * fold_num + k];
+        result.mean_F1_Score += score.F1_Score / fold_num;
+        result.mean_accuracy += score.accuracy / fold_num;
+        result.mean_M += static_cast<double>(score.M) / fold_num;
+        result.fit_seconds += score.fit_seconds / fold_num;
+        result.predict_seconds += score.predict_seconds / fold_num;
+      }
+
+      for (int k = 0; k < fold_num; ++k) {
+        const double diff = score_vec[c * fold_num + k].F1_Score - result.mean_F1_Score;
+        result.std_F1_Score += diff * diff / fold_num;
+      }
+      result.std_F1_Score = std::sqrt(result.std_F1_Score);
+    }
+
+    std::stable_sort(result_vec.begin(), result_vec.end(), [](const SweepResult &a, const SweepResult &b) {
+      if (a.mean_F1_Score != b.mean_F1_Score)
+        return a.mean_F1_Score > b.mean_F1_Score;
+      return a.fit_seconds < b.fit_seconds;
+    });
+
+    return result_vec;
+  }
+}    // namespace CrossValidation
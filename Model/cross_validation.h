@@ -0,0 +1,63 @@
+#ifndef CROSS_VALIDATION__
+#define CROSS_VALIDATION__
+
+/**
+ * @file cross_validation.h
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The k-fold cross-validation of the Adaboost, and the sweep of its hyperparameters on the shared task pool.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "dataset.h"
+#include "Eigen/Eigen"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief The hyperparameters of an Adaboost of the logistic weak learners.
+ */
+struct SweepConfig {
+  int rounds = 100;    // the size of the Adaboost
+  uint32_t passes = 1000;    // the iterations of the full batch training, or the maximum epochs of the mini-batch training
+  double learning_rate = 0.1;    // the learning rate of the full batch training, or of the first epoch of the mini-batch training
+  int batch_size = 0;    // the rows of a mini-batch, 0 for the full batch training
+};
+
+/**
+ * @brief The values of each hyperparameter, the grid search tries all the combinations,
+ *        the random search tries `sample_num` of them chosen at random.
+ */
+struct SweepSpec {
+  std::vector<int> rounds{ 100 };
+  std::vector<uint32_t> passes{ 1000 };
+  std::vector<double> learning_rate{ 0.1 };
+  std::vector<int> batch_size{ 0 };
+
+  int fold_num = 5;
+  bool random = false;
+  int sample_num = 10;    // the configurations tried by the random search
+  std::uint64_t seed = 0;    // the seed of the folds and the random search
+
+  std::vector<SweepConfig> configs() const;
+};
+
+/**
+ * @brief The scores of a configuration over the folds.
+ */
+struct SweepResult {
+  SweepConfig config;
+  double mean_F1_Score = 0.0;
+  double std_F1_Score = 0.0;
+  double mean_accuracy = 0.0;
+  double mean_M = 0.0;    // the weak learners left after the training, it's less than the rounds if a learner is 100% correct
+  double fit_seconds = 0.0;    // the training time of a fold in average
+  double predict_seconds = 0.0;    // the prediction time of a fold in average
+};
+
+namespace CrossValidation {
+  std::vector<SweepResult> sweep(const Dataset &data, const int fold_num, const std::vector<SweepConfig> &config_vec);
+}    // namespace CrossValidation
+
+#endif
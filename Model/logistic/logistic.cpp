@@ -9,12 +9,14 @@
 #include "logistic.h"
 #include "Eigen/Eigen"
 #include "make_feature.h"
+#include "trace.h"
 
 #include <vector>
 #include <cmath>
 #include <filesystem>
 #include <iostream>
 #include <algorithm>
+#include <numeric>
 #include <tuple>
 #include <random>
 #include <fstream>
@@ -26,62 +28,207 @@
  * @param train_X The training data, which is a feature matrix.
  * @param train_Y The training label.
  * @param train_weight The training weight in adaboost.
- * @param Iterations The training iterations.
+ * @param Iterations The training iterations, which are the passes over the training data, the epochs of the mini-batch training.
  * @return std::tuple<Eigen::VectorXd, double, bool> The first element of the pair is the label it predict,
  *                                            the second one is the error rate,
  *                                            the third one is a flag for 100% accuracy, if the accuracy is 100%, we can delete all the other weak learner in adaboost.
  */
 std::tuple<Eigen::VectorXd, double, bool>
-logistic::fit(const Eigen::MatrixXd &train_X, const Eigen::VectorXd &train_Y, const Eigen::MatrixXd &train_weight, uint32_t Iterations)
+logistic::fit(const Eigen::Ref<const Eigen::MatrixXd> &train_X, const Eigen::Ref<const Eigen::VectorXd> &train_Y, const Eigen::MatrixXd &train_weight, uint32_t Iterations)
 {
+  return fit(Dataset(train_X, train_Y), train_weight, Iterations);
+}
+
+/**
+ * @brief Training the weight in weak learner on the rows of the view, the rows are read in place or gathered block by block.
+ *
+ * @param train The training data and label.
+ * @param train_weight The training weight in adaboost, a weight per row of the view.
+ * @param Iterations The training iterations, which are the passes over the training data, the epochs of the mini-batch training.
+ * @return std::tuple<Eigen::VectorXd, double, bool> The same as the fit of the matrices.
+ */
+std::tuple<Eigen::VectorXd, double, bool>
+logistic::fit(const Dataset &train, const Eigen::MatrixXd &train_weight, uint32_t Iterations)
+{
+  MRL_TRACE_SCOPE("logistic::fit");
+
   uint32_t D = FEATURE_NUM;    // dimention is the column of training data, which is 5 in my case, since there is 5 features.
 
-  // use random initialize weight generated by normal distribution
-  static std::random_device rd;
-  static std::default_random_engine gen(rd());
+  // use random initialize weight generated by normal distribution, the engine is per thread since the learners may be trained at once
+  static thread_local std::default_random_engine random_gen(std::random_device{}());
+  std::default_random_engine seeded_gen(static_cast<std::default_random_engine::result_type>(init_seed));
+  std::default_random_engine &gen = init_seed == 0 ? random_gen : seeded_gen;
+
   std::normal_distribution<> dis(0, std::sqrt(D + 1));
   w = Eigen::VectorXd::NullaryExpr(D, [&]() { return dis(gen); });
   w0 = dis(gen);
 
-  Eigen::VectorXd w_momentum = Eigen::VectorXd::Zero(D);
+  if (sgd.batch_size > 0)
+    fit_mini_batch(train, train_weight, Iterations);
+  else
+    fit_full_batch(train, train_weight, Iterations);
+
+  Eigen::VectorXd pred_Y = get_label(train);
+
+  double err = 0.0;
+  bool all_correct = true;
+  for (int i = 0; i < pred_Y.size(); ++i) {
+    if (pred_Y(i) != train.label(i)) {
+      all_correct = false;
+      err -= train_weight(i);
+    }
+    else {
+      err += train_weight(i);
+    }
+  }
+
+  return { pred_Y, err, all_correct };
+}
+
+/**
+ * @brief Train the weight by the gradient of all the training data in each iteration.
+ */
+void logistic::fit_full_batch(const Dataset &train, const Eigen::MatrixXd &train_weight, uint32_t Iterations)
+{
+  Eigen::VectorXd w_momentum = Eigen::VectorXd::Zero(FEATURE_NUM);
   double w0_momentum = 0.0;
-  double alpha = 0.1;
+  train_loss_curve.clear();
+  valid_loss_curve.clear();
+  passes = Iterations;
 
   for (uint32_t i = 0; i < Iterations; ++i) {
-    double lr = alpha / (1 + i / FEATURE_NUM);
+    MRL_TRACE_SCOPE("logistic::fit iteration");
+
+    double lr = learning_rate / (1 + i / FEATURE_NUM);
 
-    Eigen::ArrayXd hx = (train_X * w).array() + w0;
-    hx = cal_logistic(hx);
-    Eigen::VectorXd tmp = train_weight.array() * (train_Y.array() - hx);
+    Eigen::VectorXd w_grad = Eigen::VectorXd::Zero(FEATURE_NUM);
+    double w0_grad = 0.0;
+    train.for_each_block([&](const int begin, const auto &train_X, const auto &train_Y) {
+      Eigen::ArrayXd hx = (train_X * w).array() + w0;
+      hx = cal_logistic(hx);
+      Eigen::VectorXd tmp = train_weight.middleRows(begin, train_X.rows()).array() * (train_Y.array() - hx);
 
-    Eigen::VectorXd w_grad = train_X.transpose() * tmp;
-    double w0_grad = tmp.sum();
+      w_grad.noalias() += train_X.transpose() * tmp;
+      w0_grad += tmp.sum();
+    });
 
     w_momentum = (w_momentum + lr * w_grad) * 0.9;
     w0_momentum = (w0_momentum + lr * w0_grad) * 0.9;
     w += w_momentum + lr * w_grad;
     w0 += w0_momentum + lr * w0_grad;
   }
+}
 
-  Eigen::VectorXd pred_Y = get_label(train_X);
+/**
+ * @brief Train the weight by the shuffled mini-batches, the gradient of a batch is weighted by the Adaboost weight of its rows.
+ *        Some rows are held out, the training stops early if their weighted loss isn't improved, then the best weight is kept.
+ *        The loss is the log loss of the logistic function 1 / (1 + e^(-x)), its gradient is (y - h(x)) * x.
+ *
+ * @param Iterations The maximum epochs.
+ */
+void logistic::fit_mini_batch(const Dataset &train, const Eigen::MatrixXd &train_weight, uint32_t Iterations)
+{
+  const int N = train.rows();
+  const auto log_loss = [](const double y, const double h) {
+    const double p = std::clamp(h, 1e-12, 1 - 1e-12);
+    return -(y * std::log(p) + (1 - y) * std::log(1 - p));
+  };
 
-  double err = 0.0;
-  bool all_correct = true;
-  for (int i = 0; i < pred_Y.size(); ++i) {
-    if (pred_Y(i) != train_Y(i)) {
-      all_correct = false;
-      err -= train_weight(i);
+  // split the rows into the training rows and the held-out rows, at least one row is kept for the training
+  std::mt19937_64 gen(sgd.seed);
+  std::vector<int> fit_vec(N);
+  std::iota(fit_vec.begin(), fit_vec.end(), 0);
+  std::shuffle(fit_vec.begin(), fit_vec.end(), gen);
+
+  const int valid_num = std::clamp(static_cast<int>(N * sgd.validation_ratio), 0, std::max(N - 1, 0));
+  const std::vector<int> valid_vec(fit_vec.begin(), fit_vec.begin() + valid_num);
+  fit_vec.erase(fit_vec.begin(), fit_vec.begin() + valid_num);
+
+  const auto valid_loss = [&]() {
+    double loss = 0.0, weight_sum = 0.0;
+    for (const int r : valid_vec) {
+      loss += train_weight(r) * log_loss(train.label(r), cal_logistic(w0 + train.row(r).dot(w)));
+      weight_sum += train_weight(r);
     }
-    else {
-      err += train_weight(i);
+    return weight_sum > 0 ? loss / weight_sum : 0.0;
+  };
+
+  Eigen::VectorXd w_momentum = Eigen::VectorXd::Zero(FEATURE_NUM);
+  double w0_momentum = 0.0;
+  Eigen::VectorXd w_grad(FEATURE_NUM);
+
+  Eigen::VectorXd best_w = w;
+  double best_w0 = w0;
+  double best_loss = valid_loss();
+  int stale_epochs = 0;
+
+  train_loss_curve.clear();
+  valid_loss_curve.clear();
+  passes = 0;
+
+  const std::size_t batch_size = sgd.batch_size;
+  for (uint32_t epoch = 0; epoch < Iterations; ++epoch) {
+    MRL_TRACE_SCOPE("logistic::fit epoch");
+
+    const double lr = sgd.learning_rate / (1 + sgd.decay * epoch);
+    std::shuffle(fit_vec.begin(), fit_vec.end(), gen);
+
+    // the training loss of the epoch is summed from the batches before their updates, thus it costs no extra pass
+    double epoch_loss = 0.0, epoch_weight = 0.0;
+    for (std::size_t begin = 0; begin < fit_vec.size(); begin += batch_size) {
+      const std::size_t end = std::min(fit_vec.size(), begin + batch_size);
+
+      w_grad.setZero();
+      double w0_grad = 0.0, batch_weight = 0.0;
+      for (std::size_t i = begin; i < end; ++i) {
+        const int r = fit_vec[i];
+        const double h = cal_logistic(w0 + train.row(r).dot(w));
+        const double g = train_weight(r) * (train.label(r) - h);
+        w_grad += g * train.row(r).transpose();
+        w0_grad += g;
+        batch_weight += train_weight(r);
+        epoch_loss += train_weight(r) * log_loss(train.label(r), h);
+      }
+
+      if (batch_weight <= 0)
+        continue;
+
+      epoch_weight += batch_weight;
+      w_momentum = 0.9 * w_momentum + lr * w_grad / batch_weight;
+      w0_momentum = 0.9 * w0_momentum + lr * w0_grad / batch_weight;
+      w += w_momentum;
+      w0 += w0_momentum;
     }
+
+    passes = epoch + 1;
+    train_loss_curve.push_back(epoch_weight > 0 ? epoch_loss / epoch_weight : 0.0);
+    if (valid_vec.empty())
+      continue;    // nothing is held out, thus it runs all the epochs
+
+    const double loss = valid_loss();
+    valid_loss_curve.push_back(loss);
+
+    stale_epochs = (loss < best_loss * (1 - sgd.min_improvement)) ? 0 : stale_epochs + 1;
+    if (loss < best_loss) {
+      best_loss = loss;
+      best_w = w;
+      best_w0 = w0;
+    }
+
+    if (stale_epochs >= sgd.patience)
+      break;
   }
 
-  return { pred_Y, err, all_correct };
+  if (!valid_vec.empty()) {
+    w = best_w;
+    w0 = best_w0;
+  }
 }
 
 /**
- * @brief Calculate the logistic function 1 / (1 + e^(-x)), which is equivalent to (tanh(x / 2) + 1)/2.
+ * @brief Calculate the squashing function of the model, (tanh(x) / 2 + 1) / 2, which is in (0.25, 0.75) and crosses 0.5 at 0.
+ *        It is not the logistic function 1 / (1 + e^(-x)), but the saved weights were trained with it, thus it's kept,
+ *        and all the training and the prediction use it, thus the probabilities and the losses of the two trainings are on the same scale.
  *
  * @param x The input array.
  * @return Eigen::ArrayXd
@@ -91,32 +238,53 @@ Eigen::ArrayXd logistic::cal_logistic(const Eigen::ArrayXd &x) const
   return (x.tanh() / 2 + 1) / 2;
 }
 
+double logistic::cal_logistic(const double x) const
+{
+  return (std::tanh(x) / 2 + 1) / 2;
+}
+
 /**
  * @brief Make prediction of the data, this function is for debug using, it's output is not an label but an probability.
  *
  * @param data The feature matrix of all section, the size is Sn*5, Sn is the total number of the data, 5 means the number of the feature.
  * @return Eigen::VectorXd The probability of the data get from the logistic function.
  */
-Eigen::VectorXd logistic::predict(const Eigen::MatrixXd &data) const
+Eigen::VectorXd logistic::predict(const Eigen::Ref<const Eigen::MatrixXd> &data) const
 {
+  MRL_TRACE_SCOPE("logistic::predict");
+
   Eigen::ArrayXd hx = (data * w).array() + w0;
 
   return cal_logistic(hx);
 }
 
+Eigen::VectorXd logistic::predict(const Dataset &data) const
+{
+  Eigen::VectorXd prob(data.rows());
+  data.for_each_block([&](const int begin, const auto &X, const auto &) { prob.segment(begin, X.rows()) = predict(X); });
+  return prob;
+}
+
 /**
  * @brief Predict the label of the data.
  *
  * @param data The feature matrix of all section, the size is Sn*5, Sn is the total number of the data, 5 means the number of the feature.
  * @return Eigen::VectorXd The label of the data. If the probability get from the logistic function >= 0.5, output 1, otherwise 0.
  */
-Eigen::VectorXd logistic::get_label(const Eigen::MatrixXd &data) const
+Eigen::VectorXd logistic::get_label(const Eigen::Ref<const Eigen::MatrixXd> &data) const
 {
   Eigen::ArrayXd hx = (data * w).array() + w0;
 
   return cal_logistic(hx).round();
 }
 
+Eigen::VectorXd logistic::get_label(const Dataset &data) const
+{
+  Eigen::VectorXd label(data.rows());
+  data.for_each_block([&](const int begin, const auto &X, const auto &) { label.segment(begin, X.rows()) = get_label(X); });
+  return label;
+}
+
 /**
  * @brief Store the weight of the weak learner.
  *
@@ -9,12 +9,27 @@
  * @date 2022-11-17
  */
 
+#include "dataset.h"
 #include "Eigen/Eigen"
 
+#include <cstdint>
 #include <vector>
 #include <fstream>
 #include <tuple>
 
+/**
+ * @brief The settings of the mini-batch training, the full batch training is used if the batch size is 0.
+ */
+struct SGDConfig {
+  int batch_size = 0;    // the rows of a mini-batch
+  double learning_rate = 0.5;    // the learning rate of the first epoch
+  double decay = 0.2;    // the learning rate of the epoch e is learning_rate / (1 + decay * e)
+  double validation_ratio = 0.1;    // the rows held out for the early stopping
+  int patience = 3;    // stop if the validation loss isn't improved in these epochs
+  double min_improvement = 1e-4;    // the relative improvement of the validation loss counted as improved
+  std::uint64_t seed = 1;    // the seed of the shuffling
+};
+
 /**
  * @brief The weak learner in Adaboost.
  */
@@ -23,12 +38,27 @@ public:
   double w0;    // w0 in the weight vector
   Eigen::VectorXd w;    // the weight vector
 
+  double learning_rate = 0.1;    // the learning rate of the full batch training
+  std::uint64_t init_seed = 0;    // the seed of the initial weight, a random one if it's 0
+  SGDConfig sgd;    // the mini-batch training settings, unused by the full batch training
+  uint32_t passes = 0;    // the passes over the training data in the last fit
+  std::vector<double> train_loss_curve;    // the weighted loss of each epoch in the last mini-batch fit
+  std::vector<double> valid_loss_curve;    // the weighted loss on the held-out rows of each epoch in the last mini-batch fit
+
 public:
-  std::tuple<Eigen::VectorXd, double, bool> fit(const Eigen::MatrixXd &train_X, const Eigen::VectorXd &train_Y, const Eigen::MatrixXd &train_weight, uint32_t Iterations);    // training
+  std::tuple<Eigen::VectorXd, double, bool> fit(const Eigen::Ref<const Eigen::MatrixXd> &train_X, const Eigen::Ref<const Eigen::VectorXd> &train_Y, const Eigen::MatrixXd &train_weight, uint32_t Iterations);    // training
+  std::tuple<Eigen::VectorXd, double, bool> fit(const Dataset &train, const Eigen::MatrixXd &train_weight, uint32_t Iterations);    // training on a view
 
   Eigen::ArrayXd cal_logistic(const Eigen::ArrayXd &x) const;    // logistic function
-  Eigen::VectorXd get_label(const Eigen::MatrixXd &section) const;    // get the label of the section
-  Eigen::VectorXd predict(const Eigen::MatrixXd &section) const;    // predict the section data
+  double cal_logistic(const double x) const;    // logistic function of a row
+  Eigen::VectorXd get_label(const Eigen::Ref<const Eigen::MatrixXd> &section) const;    // get the label of the section
+  Eigen::VectorXd get_label(const Dataset &data) const;    // get the label of the rows of the view
+  Eigen::VectorXd predict(const Eigen::Ref<const Eigen::MatrixXd> &section) const;    // predict the section data
+  Eigen::VectorXd predict(const Dataset &data) const;    // predict the rows of the view
+
+private:
+  void fit_full_batch(const Dataset &train, const Eigen::MatrixXd &train_weight, uint32_t Iterations);
+  void fit_mini_batch(const Dataset &train, const Eigen::MatrixXd &train_weight, uint32_t Iterations);
 
 public:
   void store_weight(std::ofstream &outfile) const;    // store the weight vector
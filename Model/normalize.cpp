@@ -14,48 +14,35 @@
 
 #include <iostream>
 #include <fstream>
+#include <limits>
 
 #define CLEAN_STREAM \
   stream.str("");    \
   stream.clear()
 
 /**
- * @brief Calculate the data_min and data_mm in Normalizer,
- *        which is the minimum num and max-min num of each column.
+ * @brief Calculate the data_min and data_mm of the rows of the view, the blocks of the view are reduced one by one.
  *
- * @param data The matrix will determine the data_min and data_mm, which means the scale of normalization.
+ * @param data The rows will determine the data_min and data_mm.
  */
-void Normalizer::fit(const Eigen::MatrixXd &data)
+void Normalizer::fit(const Dataset &data)
 {
-  const int COLS = data.cols();
-  data_min = Eigen::VectorXd::Zero(COLS);
-  data_mm = Eigen::VectorXd::Zero(COLS);
+  MRL_TRACE_SCOPE("Normalizer::fit");
 
-  for (int i = 0; i < COLS; ++i) {
-    data_min(i) = data.col(i).minCoeff();
-    data_mm(i) = data.col(i).maxCoeff() - data_min(i);    // max - min
+  Eigen::VectorXd data_max = Eigen::VectorXd::Constant(data.cols(), -std::numeric_limits<double>::infinity());
+  data_min = Eigen::VectorXd::Constant(data.cols(), std::numeric_limits<double>::infinity());
+  data.for_each_block([&](const int, const auto &X, const auto &) {
+    data_min = data_min.cwiseMin(X.colwise().minCoeff().transpose());
+    data_max = data_max.cwiseMax(X.colwise().maxCoeff().transpose());
+  });
+
+  data_mm = data_max - data_min;
+  for (int i = 0; i < data_mm.size(); ++i) {
     if (data_mm(i) == 0)    // if max-min is 0, it can't be division, thus assign it to 1
       data_mm(i) = 1;
   }
 }
 
-/**
- * @brief Do normalization for every column of the data.
- *
- * @param data The matrix will be normalized by min-max normalization.
- * @return Eigen::MatrixXd The result of the normalization matrix.
- */
-Eigen::MatrixXd Normalizer::transform(const Eigen::MatrixXd &data)
-{
-  Eigen::MatrixXd tf_matrix(data.rows(), data.cols());
-
-  const int COLS = data.cols();
-  for (int i = 0; i < COLS; ++i)
-    tf_matrix.col(i) = (data.col(i).array() - data_min(i)) / data_mm(i);
-
-  return tf_matrix;
-}
-
 /**
  * @brief Store the scale of the normalization matrix.
  *
@@ -10,6 +10,8 @@
  * @date 2022-11-17
  */
 
+#include "dataset.h"
+#include "trace.h"
 #include "Eigen/Eigen"
 
 class Normalizer {
@@ -18,10 +20,57 @@ public:
   Eigen::VectorXd data_mm;    // the max-min num of each column, my feature matrix have 5 column, thus the size of data_mm is 5
 
 public:
-  void fit(const Eigen::MatrixXd &data);    // calculate the data_min and data_mm
-  Eigen::MatrixXd transform(const Eigen::MatrixXd &data);    // do normalization for every column of the data
+  template <typename Derived>
+  void fit(const Eigen::MatrixBase<Derived> &data);    // calculate the data_min and data_mm
+  void fit(const Dataset &data);    // calculate the data_min and data_mm of the rows of the view
+  template <typename Derived>
+  Eigen::MatrixXd transform(const Eigen::MatrixBase<Derived> &data);    // do normalization for every column of the data
   void store_weight(std::ofstream &outfile);    // store the scale of the normalization
   void load_weight(std::ifstream &infile);    // load the scale of the normalization
 };
 
+/**
+ * @brief Calculate the data_min and data_mm in Normalizer,
+ *        which is the minimum num and max-min num of each column.
+ *        It accepts any Eigen expression, e.g. the row-major map of the label tool's store, without copying it.
+ *
+ * @param data The matrix will determine the data_min and data_mm, which means the scale of normalization.
+ */
+template <typename Derived>
+void Normalizer::fit(const Eigen::MatrixBase<Derived> &data)
+{
+  MRL_TRACE_SCOPE("Normalizer::fit");
+
+  const int COLS = data.cols();
+  data_min = Eigen::VectorXd::Zero(COLS);
+  data_mm = Eigen::VectorXd::Zero(COLS);
+
+  for (int i = 0; i < COLS; ++i) {
+    data_min(i) = data.col(i).minCoeff();
+    data_mm(i) = data.col(i).maxCoeff() - data_min(i);    // max - min
+    if (data_mm(i) == 0)    // if max-min is 0, it can't be division, thus assign it to 1
+      data_mm(i) = 1;
+  }
+}
+
+/**
+ * @brief Do normalization for every column of the data.
+ *
+ * @param data The matrix will be normalized by min-max normalization.
+ * @return Eigen::MatrixXd The result of the normalization matrix.
+ */
+template <typename Derived>
+Eigen::MatrixXd Normalizer::transform(const Eigen::MatrixBase<Derived> &data)
+{
+  MRL_TRACE_SCOPE("Normalizer::transform");
+
+  Eigen::MatrixXd tf_matrix(data.rows(), data.cols());
+
+  const int COLS = data.cols();
+  for (int i = 0; i < COLS; ++i)
+    tf_matrix.col(i) = (data.col(i).array() - data_min(i)) / data_mm(i);
+
+  return tf_matrix;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,238 @@
+/**
+ * @file simulation.cpp
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The headless simulation, it runs the pipeline of the simulation window (read -> segment -> features -> normalize -> predict)
+ *        on every frame of a raw log in parallel, then writes the prediction of each frame into a .csv or .npy file.
+ *        Execute it by `Simulation <raw data> <weight file> <HZ> <output file> [thread num]`,
+ *        or without arguments to use the paths of the simulation window.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "Controller.h"
+#include "adaboost.h"
+#include "logistic.h"
+#include "make_feature.h"
+#include "normalize.h"
+#include "file_handler.h"
+#include "npy_writer.h"
+#include "trace.h"
+#include "task_scheduler.h"
+#include "Eigen/Eigen"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The raw log of the simulation, it only reuses the transformation and the frame reading of the animation controller.
+ */
+class OfflineSimulationController : public AnimationController {
+public:
+  void check_update_frame() override {}
+
+  /**
+   * @brief Transform the raw data into the binary file, then the frames can be read by `AnimationController::read_frame`.
+   */
+  void open(const std::string &raw_path, const std::string &raw_bin_path, const int hz)
+  {
+    raw_data_path = raw_path;
+    _raw_bin_path = raw_bin_path;
+    HZ = hz;
+    transform_frame();
+  }
+
+  const std::string &raw_bin_path() const { return _frame_store->raw_bin_path(); }
+  bool xydata() const { return is_xydata; }
+};
+
+/**
+ * @brief The prediction of a frame: frame, segment_num, target_num, target_x, target_y.
+ *        The target is the mean of the last predicted segment as the simulation window, it's NaN if there is no target.
+ */
+using FramePrediction = std::array<double, 5>;
+
+constexpr int CHUNK_FRAME_NUM = 64;    // the frames of a task
+
+/**
+ * @brief Read the paths of the simulation window from its tool data.
+ *        The errors of this batch tool are returned to `main` instead of waiting for a key, thus a scripted run fails instead of hanging.
+ *
+ * @return true if the tool data is read.
+ */
+static bool read_tool_data(std::string &raw_data_path, std::string &weight_data_path, int &HZ)
+{
+  const std::string tool_data_path = FileHandler::get_MRL_project_root() + "/dataset/binary_data/MesToolSimulationController.dat";
+  std::ifstream infile(tool_data_path);
+  if (infile.fail()) {
+    std::cerr << "cant open " << tool_data_path << ", open the simulation window once or pass the paths by arguments\n";
+    return false;
+  }
+
+  std::string raw_bin_path;
+  std::getline(infile, raw_data_path);
+  std::getline(infile, raw_bin_path);    // the binary file of the window, not used here thus the window's one isn't overwritten
+  std::getline(infile, weight_data_path);
+  infile >> HZ;
+  return true;
+}
+
+/**
+ * @brief Run the pipeline on every frame, the frames are split into chunks run by the task pool.
+ *
+ * @param controller The opened raw log.
+ * @param Model The trained model, it's only read by the tasks.
+ * @param normalizer The normalizer of the model, it's only read by the tasks.
+ * @param prediction_vec The prediction of each frame.
+ * @return true if all the frames are predicted, false if the binary raw data can't be opened.
+ */
+static bool simulate(const OfflineSimulationController &controller, Adaboost<logistic> &Model, Normalizer &normalizer, std::vector<FramePrediction> &prediction_vec)
+{
+  MRL_TRACE_SCOPE("simulate");
+  const int frame_num = controller.max_frame + 1;
+  const int HZ = controller.HZ;
+  const bool is_xydata = controller.xydata();
+
+  prediction_vec.assign(std::max(frame_num, 0), FramePrediction{});
+
+  // the tasks run on the pool workers, thus a failure is recorded and returned after all the tasks are done
+  std::atomic<bool> open_failed = false;
+  TaskScheduler::instance().parallel_for(0, frame_num, CHUNK_FRAME_NUM, [&](const int chunk_begin, const int chunk_end) {
+    if (open_failed)
+      return;
+
+    MappedWindow raw_bin_window;    // each chunk slides its own window
+    if (!raw_bin_window.open(controller.raw_bin_path())) {
+      open_failed = true;
+      return;
+    }
+
+    Eigen::MatrixXd xy_data;
+    for (int frame_i = chunk_begin; frame_i < chunk_end; ++frame_i) {
+      MRL_TRACE_SCOPE("simulate frame");
+      AnimationController::read_frame(raw_bin_window, frame_i, HZ, is_xydata, xy_data);
+      const auto [feature_matrix, segment_vec] = MakeFeatures::section_to_feature(xy_data);
+
+      FramePrediction &prediction = prediction_vec[frame_i];
+      prediction = { static_cast<double>(frame_i), static_cast<double>(segment_vec.size()), 0,
+                     std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN() };
+      if (segment_vec.empty())
+        continue;
+
+      const Eigen::VectorXd pred_Y = Model.predict(normalizer.transform(feature_matrix));
+      for (int i = 0; i < static_cast<int>(segment_vec.size()); ++i) {
+        if (pred_Y(i) == 1) {
+          ++prediction[2];
+          prediction[3] = segment_vec[i].col(0).mean();
+          prediction[4] = segment_vec[i].col(1).mean();
+        }
+      }
+    }
+  });
+
+  if (open_failed) {
+    std::cerr << "cant open " << controller.raw_bin_path() << '\n';
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * @brief Write the predictions into a .npy file (an N*5 float64 array) if the path ends with .npy, otherwise a .csv file.
+ *
+ * @return true if the file is written.
+ */
+static bool write_prediction(const std::string &output_path, const std::vector<FramePrediction> &prediction_vec)
+{
+  MRL_TRACE_SCOPE("write_prediction");
+  if (std::filesystem::path(output_path).extension() == ".npy") {
+    NpyWriter writer;
+    if (!writer.open(output_path, "<f8", 5)) {
+      std::cerr << "cant open " << output_path << '\n';
+      return false;
+    }
+
+    writer.write(prediction_vec.data(), static_cast<std::int64_t>(prediction_vec.size()));
+    writer.close(true);
+    return true;
+  }
+
+  std::ofstream outfile(output_path, std::ios::trunc);
+  if (outfile.fail()) {
+    std::cerr << "cant open " << output_path << '\n';
+    return false;
+  }
+
+  outfile << "frame,segment_num,target_num,target_x,target_y\n"
+          << std::setprecision(std::numeric_limits<double>::max_digits10);
+  for (const FramePrediction &prediction : prediction_vec) {
+    outfile << static_cast<int>(prediction[0]) << ',' << static_cast<int>(prediction[1]) << ',' << static_cast<int>(prediction[2]) << ','
+            << prediction[3] << ',' << prediction[4] << '\n';
+  }
+  return true;
+}
+
+int main(int argc, char *argv[])
+{
+  std::string raw_data_path, weight_data_path, output_path, raw_bin_path;
+  int HZ = 360;
+  int thread_num = 0;    // the default threads of the pool
+
+  if (argc == 1) {
+    if (!read_tool_data(raw_data_path, weight_data_path, HZ))
+      return 1;
+    output_path = FileHandler::get_MRL_project_root() + "/dataset/simulation_prediction.csv";
+    raw_bin_path = FileHandler::get_MRL_project_root() + "/dataset/binary_data/offline_simulation_raw_data_bin.txt";
+  }
+  else if (argc == 5 || argc == 6) {
+    raw_data_path = argv[1];
+    weight_data_path = argv[2];
+    HZ = std::stoi(argv[3]);
+    output_path = argv[4];
+    raw_bin_path = output_path + ".raw_bin";    // next to the output, thus it doesn't need the project root
+    if (argc == 6)
+      thread_num = std::max(1, std::stoi(argv[5]));
+  }
+  else {
+    std::cerr << "usage: " << argv[0] << " [<raw data> <weight file> <HZ> <output .csv or .npy> [thread num]]\n";
+    return 1;
+  }
+
+  if (thread_num > 0)
+    TaskScheduler::set_thread_num(thread_num);
+
+  Adaboost<logistic> Model;
+  Normalizer normalizer;
+  FileHandler::load_weight(weight_data_path, Model, normalizer);
+
+  std::vector<FramePrediction> prediction_vec;
+  double transform_s = 0, simulate_s = 0;
+  bool simulated;
+  {
+    auto start = std::chrono::steady_clock::now();
+    OfflineSimulationController controller;
+    controller.open(raw_data_path, raw_bin_path, HZ);
+    transform_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    simulated = simulate(controller, Model, normalizer, prediction_vec);
+    simulate_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+  std::filesystem::remove(raw_bin_path);    // the controller has unmapped it
+
+  if (!simulated || !write_prediction(output_path, prediction_vec))
+    return 1;
+
+  std::cout << "transformed " << raw_data_path << " in " << transform_s << " s\n"
+            << "simulated " << prediction_vec.size() << " frames with " << TaskScheduler::instance().thread_num() << " threads in " << simulate_s << " s ("
+            << prediction_vec.size() / std::max(simulate_s, 1e-9) << " frames/s)\n"
+            << "wrote " << output_path << '\n';
+}
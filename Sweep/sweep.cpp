@@ -0,0 +1,167 @@
+/**
+ * @file sweep.cpp
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief Choose the hyperparameters of the Adaboost by the k-fold cross-validation, the folds of all the configurations run on the task pool at once.
+ *        The search is described by a JSON file, e.g. Sweep/sweep_spec.json, the keys are optional:
+ *        "rounds", "passes", "learning_rate" and "batch_size" are the lists of the values,
+ *        "search" is "grid" or "random", "samples" is the configurations tried by the random search, "folds" and "seed" are for the folds.
+ *        Execute it by `Sweep [--spec <json>] [--data <x path> <y path> <rows>] [--threads <n>] [--csv <output>]`.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "cross_validation.h"
+#include "file_handler.h"
+#include "make_feature.h"
+#include "normalize.h"
+#include "task_scheduler.h"
+#include "json.hpp"
+#include "Eigen/Eigen"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Read the search from the JSON file, the missing keys keep the default values of `SweepSpec`.
+ */
+static SweepSpec load_spec(const std::string &spec_path)
+{
+  std::ifstream infile(spec_path);
+  if (infile.fail()) {
+    std::cerr << "cant open " << spec_path << '\n';
+    std::cin.get();
+    exit(1);
+  }
+
+  const nlohmann::json root = nlohmann::json::parse(infile, nullptr, false);
+  if (root.is_discarded() || !root.is_object()) {
+    std::cerr << spec_path << " is not a JSON object\n";
+    std::cin.get();
+    exit(1);
+  }
+
+  SweepSpec spec;
+  spec.rounds = root.value("rounds", spec.rounds);
+  spec.passes = root.value("passes", spec.passes);
+  spec.learning_rate = root.value("learning_rate", spec.learning_rate);
+  spec.batch_size = root.value("batch_size", spec.batch_size);
+  spec.fold_num = root.value("folds", spec.fold_num);
+  spec.random = root.value("search", std::string("grid")) == "random";
+  spec.sample_num = root.value("samples", spec.sample_num);
+  spec.seed = root.value("seed", spec.seed);
+  return spec;
+}
+
+static void write_csv(const std::string &csv_path, const std::vector<SweepResult> &result_vec)
+{
+  std::ofstream outfile(csv_path, std::ios::trunc);
+  if (outfile.fail()) {
+    std::cerr << "cant open " << csv_path << '\n';
+    return;
+  }
+
+  outfile << "rank,rounds,passes,learning_rate,batch_size,mean_f1,std_f1,mean_accuracy,mean_learners,fit_seconds,predict_seconds\n";
+  for (std::size_t i = 0; i < result_vec.size(); ++i) {
+    const SweepResult &result = result_vec[i];
+    outfile << i + 1 << ',' << result.config.rounds << ',' << result.config.passes << ',' << result.config.learning_rate << ','
+            << result.config.batch_size << ',' << result.mean_F1_Score << ',' << result.std_F1_Score << ',' << result.mean_accuracy << ','
+            << result.mean_M << ',' << result.fit_seconds << ',' << result.predict_seconds << '\n';
+  }
+}
+
+static void print_usage(const char *program)
+{
+  std::cerr << "usage: " << program << " [options]\n"
+            << "  --spec <json>                  the search, default Sweep/sweep_spec.json of the project\n"
+            << "  --data <x path> <y path> <n>   the features and the labels of n segments, default the demo training data\n"
+            << "  --threads <n>                  the threads of the task pool, default all the cores\n"
+            << "  --csv <output>                 also write the ranked results into the CSV file\n";
+}
+
+int main(int argc, char *argv[])
+{
+  const std::string filepath = FileHandler::get_MRL_project_root();
+
+  std::string spec_path = filepath + "/Sweep/sweep_spec.json";
+  std::string x_path = filepath + "/dataset/demo_data/default_train_x.txt";
+  std::string y_path = filepath + "/dataset/demo_data/default_train_y.txt";
+  int row_num = 18268;    // the rows of default_train_x.txt
+  std::string csv_path;
+  int thread_num = 0;    // the default threads of the pool
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const int value_num = arg == "--help" ? 0 : (arg == "--data" ? 3 : 1);
+    if (i + value_num >= argc) {
+      print_usage(argv[0]);
+      return 1;
+    }
+
+    if (arg == "--spec")
+      spec_path = argv[++i];
+    else if (arg == "--data") {
+      x_path = argv[++i];
+      y_path = argv[++i];
+      row_num = std::stoi(argv[++i]);
+    }
+    else if (arg == "--threads")
+      thread_num = std::max(1, std::stoi(argv[++i]));
+    else if (arg == "--csv")
+      csv_path = argv[++i];
+    else {
+      print_usage(argv[0]);
+      return arg == "--help" ? 0 : 1;
+    }
+  }
+
+  if (thread_num > 0)
+    TaskScheduler::set_thread_num(thread_num);
+
+  const SweepSpec spec = load_spec(spec_path);
+  const std::vector<SweepConfig> config_vec = spec.configs();
+  if (config_vec.empty()) {
+    std::cerr << spec_path << " has no configuration to try\n";
+    return 1;
+  }
+
+  puts("reading the dataset...");
+  const Eigen::MatrixXd X = LoadMatrix::readDataSet(x_path, row_num, FEATURE_NUM);
+  const Eigen::VectorXd Y = LoadMatrix::readLabel(y_path, row_num);
+
+  // the folds are the views of the dataset normalized once, it's read-only for all the jobs.
+  // the rows are shuffled while they're normalized, thus the rows of a fold are consecutive and read in place.
+  std::vector<int> row_vec(row_num);
+  std::iota(row_vec.begin(), row_vec.end(), 0);
+  std::shuffle(row_vec.begin(), row_vec.end(), std::mt19937_64(spec.seed));
+
+  Normalizer normalizer;
+  normalizer.fit(X);
+  const Dataset data = Dataset::own(normalizer.transform(X(row_vec, Eigen::all)), Y(row_vec));
+  const int fold_num = std::clamp(spec.fold_num, 2, std::max(2, data.rows()));
+
+  std::cout << config_vec.size() << " configurations, " << fold_num << " folds, " << TaskScheduler::instance().thread_num() << " threads\n";
+
+  const auto start = std::chrono::steady_clock::now();
+  const std::vector<SweepResult> result_vec = CrossValidation::sweep(data, fold_num, config_vec);
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::printf("%-5s %7s %7s %8s %6s %10s %8s %9s %9s %10s %12s\n", "rank", "rounds", "passes", "lr", "batch", "F1", "std", "accuracy", "learners",
+              "fit s", "predict ms");
+  for (std::size_t i = 0; i < result_vec.size(); ++i) {
+    const SweepResult &result = result_vec[i];
+    std::printf("%-5zu %7d %7u %8g %6d %10.5f %8.5f %9.5f %9.1f %10.3f %12.3f\n", i + 1, result.config.rounds, result.config.passes,
+                result.config.learning_rate, result.config.batch_size, result.mean_F1_Score, result.std_F1_Score, result.mean_accuracy,
+                result.mean_M, result.fit_seconds, result.predict_seconds * 1e3);
+  }
+  std::cout << config_vec.size() * fold_num << " folds in " << seconds << " s\n";
+
+  if (!csv_path.empty())
+    write_csv(csv_path, result_vec);
+}
@@ -0,0 +1,25 @@
+# Compare the disassemblies of the object with the trace scopes and the object without them, run by the trace_codegen_check target.
+# -DOBJDUMP=<objdump> -DWITH_SCOPES=<object> -DWITHOUT_SCOPES=<object>
+
+foreach(OBJECT WITH_SCOPES WITHOUT_SCOPES)
+  execute_process(
+    COMMAND ${OBJDUMP} -d --no-show-raw-insn ${${OBJECT}}
+    OUTPUT_VARIABLE ${OBJECT}_DISASSEMBLY
+    RESULT_VARIABLE OBJDUMP_RESULT
+  )
+  if(NOT OBJDUMP_RESULT EQUAL 0)
+    message(FATAL_ERROR "cant disassemble ${${OBJECT}}")
+  endif()
+
+  # the header has the path of the object, only the code is compared
+  string(FIND "${${OBJECT}_DISASSEMBLY}" "Disassembly of section" CODE_BEGIN)
+  string(SUBSTRING "${${OBJECT}_DISASSEMBLY}" ${CODE_BEGIN} -1 ${OBJECT}_DISASSEMBLY)
+endforeach()
+
+if(NOT WITH_SCOPES_DISASSEMBLY STREQUAL WITHOUT_SCOPES_DISASSEMBLY)
+  file(WRITE ${WITH_SCOPES}.dis "${WITH_SCOPES_DISASSEMBLY}")
+  file(WRITE ${WITHOUT_SCOPES}.dis "${WITHOUT_SCOPES_DISASSEMBLY}")
+  message(FATAL_ERROR "the disabled trace scopes change the code, see the difference of ${WITH_SCOPES}.dis and ${WITHOUT_SCOPES}.dis")
+endif()
+
+message(STATUS "the disabled trace scopes compile to nothing")
@@ -13,17 +13,47 @@
 #include "normalize.h"
 #include "file_handler.h"
 #include "metric.h"
+#include "label_session.h"
+#include "dataset.h"
 #include "Eigen/Dense"
 
+#include <chrono>
+#include <fstream>
 #include <iostream>
 #include <limits>
 
+/**
+ * @brief Write the convergence curves of the mini-batch training, a line per epoch of each weak learner.
+ */
+static void write_training_curve(const std::string &curve_path, const Adaboost<logistic> &A)
+{
+  std::ofstream outfile(curve_path, std::ios::trunc);
+  if (outfile.fail()) {
+    std::cerr << "cant open " << curve_path << '\n';
+    return;
+  }
+
+  outfile << "learner,epoch,train_loss,valid_loss\n";
+  for (int m = 0; m < A.M; ++m) {
+    const logistic &learner = A.vec[m];
+    for (std::size_t e = 0; e < learner.train_loss_curve.size(); ++e) {
+      outfile << m << ',' << e << ',' << learner.train_loss_curve[e] << ',';
+      if (e < learner.valid_loss_curve.size())
+        outfile << learner.valid_loss_curve[e];
+      outfile << '\n';
+    }
+  }
+}
+
 int main()
 {
   const std::string filepath = FileHandler::get_MRL_project_root();
 
   int case_num = 0;
   int sample = 0;
+  int source_num = 0;
+  int batch_size = 0;
+  std::int64_t max_total_passes = 0;
 
   std::cout << "Input 1 if training, others if loading\n>";
   std::cin >> case_num;
@@ -31,40 +61,120 @@ int main()
   if (case_num == 1) {
     std::cout << "input sample numbers\n>";
     std::cin >> sample;
+
+    std::cout << "input the mini-batch size, 0 for the full batch training\n>";
+    std::cin >> batch_size;
+
+    std::cout << "input the maximum passes over the training data of all the weak learners, 0 for no limit\n>";
+    std::cin >> max_total_passes;
   }
+
+  std::cout << "Input 1 if reading the label tool's binary stores, others if reading the text dataset\n>";
+  std::cin >> source_num;
+
   std::cin.clear();
   std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 
-  puts("read training data...");
-  Eigen::MatrixXd train_X = LoadMatrix::readDataSet(filepath + "/dataset/demo_data/default_train_x.txt", 18268, FEATURE_NUM);    // file, row, col
+  Eigen::MatrixXd train_X, test_X;
+  Eigen::VectorXd train_Y, test_Y;
 
-  puts("reading training label...");
-  Eigen::VectorXd train_Y = LoadMatrix::readLabel(filepath + "/dataset/demo_data/default_train_y.txt", 18268);    // file, segment num(row)
+  LabelSession session;
+  int train_rows = 0;    // the first segments of the session are the training data, the others are the testing data
 
-  puts("reading testing data...");
-  Eigen::MatrixXd test_X = LoadMatrix::readDataSet(filepath + "/dataset/demo_data/default_test_x.txt", 17865, FEATURE_NUM);
+  if (source_num == 1) {
+    puts("mapping the label tool's binary stores...");
+    session.open_tool_data(filepath + "/dataset/binary_data/MesToolLabelController.dat");
+    if (session.segment_num() < 2) {
+      std::cerr << "there are not enough labeled segments in the stores\n";
+      std::cin.get();
+      exit(1);
+    }
+
+    std::cout << session.frame_num() << " frames, " << session.segment_num() << " segments, "
+              << (session.is_zero_copy() ? "mapped in place\n" : "gathered since the store is not compacted\n");
+
+    train_rows = session.segment_num() * 4 / 5;
+    train_Y = session.labels().head(train_rows).cast<double>();
+    test_Y = session.labels().tail(session.segment_num() - train_rows).cast<double>();
+  }
+  else {
+    puts("read training data...");
+    train_X = LoadMatrix::readDataSet(filepath + "/dataset/demo_data/default_train_x.txt", 18268, FEATURE_NUM);    // file, row, col
+
+    puts("reading training label...");
+    train_Y = LoadMatrix::readLabel(filepath + "/dataset/demo_data/default_train_y.txt", 18268);    // file, segment num(row)
 
-  puts("reading testing label...");
-  Eigen::VectorXd test_Y = LoadMatrix::readLabel(filepath + "/dataset/demo_data/default_test_y.txt", 17865);
+    puts("reading testing data...");
+    test_X = LoadMatrix::readDataSet(filepath + "/dataset/demo_data/default_test_x.txt", 17865, FEATURE_NUM);
+
+    puts("reading testing label...");
+    test_Y = LoadMatrix::readLabel(filepath + "/dataset/demo_data/default_test_y.txt", 17865);
+  }
+
+  // normalize the data, the features of the session are read from the mapped store directly, the normalized matrix is the only copy.
+  const auto normalize_data = [&](Normalizer &normalizer, const bool fit) {
+    if (source_num == 1) {
+      const LabelSession::FeatureMap features = session.features();
+      if (fit) {
+        normalizer.fit(features.topRows(train_rows));
+        train_X = normalizer.transform(features.topRows(train_rows));
+      }
+      test_X = normalizer.transform(features.bottomRows(session.segment_num() - train_rows));
+    }
+    else {
+      if (fit) {
+        normalizer.fit(train_X);
+        train_X = normalizer.transform(train_X);
+      }
+      test_X = normalizer.transform(test_X);
+    }
+  };
 
   if (case_num == 1) {
     /* fitting */
 
     Normalizer normalizer;
-    normalizer.fit(train_X);
-    train_X = normalizer.transform(train_X);
-    test_X = normalizer.transform(test_X);
+    normalize_data(normalizer, true);
+
+    // hold out a fifth of the training data, it decides when the rounds stop and which weak learners are pruned.
+    // both parts are the views of the shuffled rows, the training data isn't copied.
+    const Dataset shuffled_data = Dataset(train_X, train_Y).shuffle(0);
+    const int valid_num = shuffled_data.rows() / 5;
+    const Dataset valid_data = shuffled_data.range(0, valid_num);
+    const Dataset fit_data = shuffled_data.range(valid_num, shuffled_data.rows());
 
     for (int i = 0; i < sample; ++i) {
       std::cout << "========================================================================================\n";
       std::cout << "training sample " << i + 1 << "...\n";
       puts("start tranning");
       Adaboost<logistic> A(100);
-      A.fit(train_X, train_Y);
+      A.max_total_passes = max_total_passes;
+      if (batch_size > 0) {
+        A.learner_passes = 50;    // the maximum epochs, most weak learners stop early
+        for (int m = 0; m < A.M; ++m) {
+          A.vec[m].sgd.batch_size = batch_size;
+          A.vec[m].sgd.seed = static_cast<std::uint64_t>(i) * A.M + m + 1;
+        }
+      }
+
+      const auto start = std::chrono::steady_clock::now();
+      A.fit(fit_data, valid_data);
+      std::cout << "\ntrained " << A.rounds_trained << " rounds with " << A.total_passes << " passes in "
+                << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s\n";
+
+      const int best_M = A.M;
+      const int pruned_num = A.prune(valid_data);
+      std::cout << "kept the best " << best_M << " rounds, pruned " << pruned_num << " weak learners, " << A.M << " left\n";
+
+      if (batch_size > 0)
+        write_training_curve(filepath + "/dataset/weight_data/adaboost_training_curve.csv", A);
 
       // prediction
       puts("make prediction");
+      const auto predict_start = std::chrono::steady_clock::now();
       Eigen::VectorXd pred_Y = A.predict(test_X);
+      std::cout << "predicted " << test_X.rows() << " segments in "
+                << std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - predict_start).count() / test_X.rows() << " us per segment\n";
 
       puts("cal confusion matrix");
       Eigen::MatrixXd confusion_matrix = metric::cal_confusion_matrix(test_Y, pred_Y);
@@ -82,7 +192,7 @@ int main()
     FileHandler::load_weight(filepath + "/dataset/weight_data/adaboost_ball_weight.txt", A, normalizer);
 
     puts("Transforming test data...");
-    test_X = normalizer.transform(test_X);
+    normalize_data(normalizer, false);
 
     puts("make prediction");
     Eigen::VectorXd pred_Y = A.predict(test_X);
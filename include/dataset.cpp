@@ -0,0 +1,155 @@
+/**
+ * @file dataset.cpp
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The implementation of the dataset view.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "dataset.h"
+#include "Eigen/Eigen"
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief The view of all the rows, it doesn't own the matrices, the caller keeps them alive while the views are used.
+ *        The matrices must be the columns of the storage, not a temporary copy made by `Eigen::Ref` for an expression.
+ */
+Dataset::Dataset(const Eigen::Ref<const Eigen::MatrixXd> &X, const Eigen::Ref<const Eigen::VectorXd> &Y)
+    : Dataset(X)
+{
+  _Y = Y.data();
+}
+
+Dataset::Dataset(const Eigen::Ref<const Eigen::MatrixXd> &X)
+    : _X(X.data()),
+      _storage_rows(X.rows()),
+      _outer_stride(X.outerStride()),
+      _cols(static_cast<int>(X.cols())),
+      _end(static_cast<int>(X.rows()))
+{
+}
+
+/**
+ * @brief The view of all the rows, it owns the matrices, which are shared by all the views made from it.
+ */
+Dataset Dataset::own(Eigen::MatrixXd X, Eigen::VectorXd Y)
+{
+  auto storage = std::make_shared<std::pair<Eigen::MatrixXd, Eigen::VectorXd>>(std::move(X), std::move(Y));
+
+  Dataset dataset(storage->first, storage->second);
+  dataset._owner = storage;
+  return dataset;
+}
+
+/**
+ * @brief The rows [begin, end) of the view, a range of a list of indices shares the list.
+ */
+Dataset Dataset::range(const int begin, const int end) const
+{
+  Dataset dataset = *this;
+  dataset._begin = _begin + begin;
+  dataset._end = _begin + end;
+  return dataset;
+}
+
+/**
+ * @brief The rows of the view listed in the vector, a row can be listed more than once.
+ */
+Dataset Dataset::select(const std::vector<int> &row_vec) const
+{
+  std::vector<int> storage_row_vec(row_vec.size());
+  std::transform(row_vec.begin(), row_vec.end(), storage_row_vec.begin(), [this](const int r) { return storage_row(r); });
+  return _with_rows(std::move(storage_row_vec));
+}
+
+/**
+ * @brief The rows of the view in a random order.
+ */
+Dataset Dataset::shuffle(const std::uint64_t seed) const
+{
+  std::vector<int> row_vec(rows());
+  std::iota(row_vec.begin(), row_vec.end(), 0);
+  std::shuffle(row_vec.begin(), row_vec.end(), std::mt19937_64(seed));
+  return select(row_vec);
+}
+
+/**
+ * @brief The rows of the view sampled with replacement, in the order of the storage like the training rows of a fold.
+ */
+Dataset Dataset::bootstrap(const int sample_num, const std::uint64_t seed) const
+{
+  std::mt19937_64 gen(seed);
+  std::uniform_int_distribution<int> dis(0, std::max(rows() - 1, 0));
+
+  // count the samples of each storage row, thus the sorted rows are listed without sorting
+  std::vector<int> count_vec(rows() > 0 ? _storage_rows : 0);
+  for (int i = 0; i < sample_num && rows() > 0; ++i)
+    ++count_vec[storage_row(dis(gen))];
+
+  std::vector<int> row_vec;
+  row_vec.reserve(rows() > 0 ? sample_num : 0);
+  for (int r = 0; r < static_cast<int>(count_vec.size()); ++r)
+    row_vec.insert(row_vec.end(), count_vec[r], r);
+  return _with_rows(std::move(row_vec));
+}
+
+/**
+ * @brief The training rows and the validation rows of a fold, the validation rows are the `fold`-th of the `fold_num` consecutive parts of the view.
+ *        The validation rows are a range of the view, the training rows are a list of indices in the order of the storage,
+ *        thus a shuffled view is still gathered nearly in sequence, the order of the rows doesn't matter to the training.
+ *
+ * @return std::pair<Dataset, Dataset> The training rows and the validation rows.
+ */
+std::pair<Dataset, Dataset> Dataset::fold(const int fold, const int fold_num) const
+{
+  const int valid_begin = static_cast<int>(static_cast<std::int64_t>(rows()) * fold / fold_num);
+  const int valid_end = static_cast<int>(static_cast<std::int64_t>(rows()) * (fold + 1) / fold_num);
+
+  std::vector<int> train_row_vec;
+  train_row_vec.reserve(rows() - (valid_end - valid_begin));
+  for (int i = 0; i < rows(); ++i) {
+    if (i < valid_begin || i >= valid_end)
+      train_row_vec.push_back(storage_row(i));
+  }
+  std::sort(train_row_vec.begin(), train_row_vec.end());
+
+  return { _with_rows(std::move(train_row_vec)), range(valid_begin, valid_end) };
+}
+
+Eigen::MatrixXd Dataset::gather_features() const
+{
+  Eigen::MatrixXd X(rows(), _cols);
+  for_each_block([&](const int begin, const auto &block_X, const auto &) { X.middleRows(begin, block_X.rows()) = block_X; });
+  return X;
+}
+
+Eigen::VectorXd Dataset::gather_labels() const
+{
+  Eigen::VectorXd Y(_Y ? rows() : 0);
+  for (int i = 0; i < Y.size(); ++i)
+    Y(i) = label(i);
+  return Y;
+}
+
+std::size_t Dataset::index_bytes() const
+{
+  return _row_vec ? _row_vec->size() * sizeof(int) : 0;
+}
+
+/**
+ * @brief The view of the listed storage rows.
+ */
+Dataset Dataset::_with_rows(std::vector<int> row_vec) const
+{
+  Dataset dataset = *this;
+  dataset._begin = 0;
+  dataset._end = static_cast<int>(row_vec.size());
+  dataset._row_vec = std::make_shared<const std::vector<int>>(std::move(row_vec));
+  return dataset;
+}
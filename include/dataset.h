@@ -0,0 +1,150 @@
+#ifndef DATASET_H__
+#define DATASET_H__
+
+/**
+ * @file dataset.h
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The view of the rows of a feature matrix and its labels, a subset, a fold or a bootstrap sample is a view of the same storage.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "Eigen/Eigen"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief The selected rows of a feature matrix and its labels, they are a range of the rows or a list of the row indices.
+ *        A view of a view selects the rows of the same storage, thus it costs at most an index per row, the matrix is never copied.
+ *        The storage is shared by the views if it's owned by the dataset (`Dataset::own`),
+ *        otherwise the caller keeps the matrices alive while the views are used.
+ *        The models read a view by `for_each_block`, a range is read in place, a list of indices is gathered block by block.
+ */
+class Dataset {
+public:
+  static constexpr int GATHER_ROW_NUM = 1024;    // the rows of a gathered block, it's small enough to stay in the cache
+  static constexpr int RUN_ROW_NUM = 256;    // the consecutive storage rows read in place instead of gathered
+
+  Dataset() = default;
+  Dataset(const Eigen::Ref<const Eigen::MatrixXd> &X, const Eigen::Ref<const Eigen::VectorXd> &Y);
+  explicit Dataset(const Eigen::Ref<const Eigen::MatrixXd> &X);    // without the labels, e.g. for the prediction
+  static Dataset own(Eigen::MatrixXd X, Eigen::VectorXd Y);
+
+  int rows() const { return _end - _begin; }
+  int cols() const { return _cols; }
+  bool has_label() const { return _Y != nullptr; }
+  bool is_range() const { return _row_vec == nullptr; }
+
+  int storage_row(const int i) const { return _row_vec ? (*_row_vec)[_begin + i] : _begin + i; }    // the row of the storage of the i-th row of the view
+  Eigen::Map<const Eigen::RowVectorXd, 0, Eigen::InnerStride<>> row(const int i) const
+  {
+    return { _X + storage_row(i), _cols, Eigen::InnerStride<>(_outer_stride) };
+  }
+  double label(const int i) const { return _Y[storage_row(i)]; }
+
+  Dataset range(const int begin, const int end) const;
+  Dataset select(const std::vector<int> &row_vec) const;
+  Dataset shuffle(const std::uint64_t seed) const;
+  Dataset bootstrap(const int sample_num, const std::uint64_t seed) const;
+  std::pair<Dataset, Dataset> fold(const int fold, const int fold_num) const;
+
+  Eigen::MatrixXd gather_features() const;
+  Eigen::VectorXd gather_labels() const;
+  std::size_t index_bytes() const;    // the memory of the row indices of the view, 0 for a range
+
+  template <typename Function>
+  void for_each_block(Function &&function) const;
+
+private:
+  using StorageMap = Eigen::Map<const Eigen::MatrixXd, 0, Eigen::OuterStride<>>;
+
+  StorageMap _storage() const { return StorageMap(_X, _storage_rows, _cols, Eigen::OuterStride<>(_outer_stride)); }
+  Dataset _with_rows(std::vector<int> row_vec) const;
+
+private:
+  std::shared_ptr<const void> _owner;    // the owned storage, null if the caller keeps it
+  const double *_X = nullptr;    // the column-major features
+  Eigen::Index _storage_rows = 0;
+  Eigen::Index _outer_stride = 0;
+  int _cols = 0;
+  const double *_Y = nullptr;    // the labels, null if there is no label
+
+  std::shared_ptr<const std::vector<int>> _row_vec;    // the selected rows of the storage, the views of a range of it share it
+  int _begin = 0;    // the range of the storage rows, or of `_row_vec` if it's not null
+  int _end = 0;
+};
+
+/**
+ * @brief Call `function(begin, X, Y)` for the consecutive rows of the view, `begin` is the first row of the block in the view,
+ *        `X` and `Y` are `Eigen::Ref` of the features and the labels of the block, `Y` is empty if there is no label.
+ *        A range is a single block read in place. In a list of indices, a run of at least `RUN_ROW_NUM` consecutive storage rows
+ *        (e.g. the training rows of a fold of a range) is a block read in place, the other rows are gathered into blocks of `GATHER_ROW_NUM` rows.
+ */
+template <typename Function>
+void Dataset::for_each_block(Function &&function) const
+{
+  using FeatureBlock = Eigen::Ref<const Eigen::MatrixXd>;
+  using LabelBlock = Eigen::Ref<const Eigen::VectorXd>;
+
+  if (rows() == 0)
+    return;
+
+  if (is_range()) {
+    const Eigen::Map<const Eigen::VectorXd> Y(_Y ? _Y + _begin : nullptr, _Y ? rows() : 0);
+    function(0, FeatureBlock(_storage().middleRows(_begin, rows())), LabelBlock(Y));
+    return;
+  }
+
+  const int *row_ptr = _row_vec->data() + _begin;
+  Eigen::MatrixXd X;
+  Eigen::VectorXd Y;
+  for (int begin = 0; begin < rows();) {
+    int run = 1;
+    while (begin + run < rows() && row_ptr[begin + run] == row_ptr[begin] + run)
+      ++run;
+
+    if (run >= RUN_ROW_NUM) {
+      const Eigen::Map<const Eigen::VectorXd> run_Y(_Y ? _Y + row_ptr[begin] : nullptr, _Y ? run : 0);
+      function(begin, FeatureBlock(_storage().middleRows(row_ptr[begin], run)), LabelBlock(run_Y));
+      begin += run;
+      continue;
+    }
+
+    // gather the rows before the next long run
+    int end = begin + run, run_begin = end;
+    for (; end < rows() && end - begin < GATHER_ROW_NUM; ++end) {
+      if (row_ptr[end] != row_ptr[end - 1] + 1)
+        run_begin = end;
+      else if (end + 1 - run_begin >= RUN_ROW_NUM)
+        break;
+    }
+    if (end < rows() && end - begin < GATHER_ROW_NUM)
+      end = run_begin;
+    const int n = end - begin;
+
+    if (X.rows() == 0) {
+      X.resize(std::min(rows(), GATHER_ROW_NUM), _cols);
+      Y.resize(_Y ? X.rows() : 0);
+    }
+
+    // the block is gathered column by column, thus the rows of a column are read from a single column of the storage
+    for (int c = 0; c < _cols; ++c) {
+      const double *storage_col = _X + c * _outer_stride;
+      double *col = X.col(c).data();
+      for (int i = 0; i < n; ++i)
+        col[i] = storage_col[row_ptr[begin + i]];
+    }
+    for (int i = 0; i < Y.size() && i < n; ++i)
+      Y(i) = _Y[row_ptr[begin + i]];
+
+    function(begin, FeatureBlock(X.topRows(n)), LabelBlock(Y.head(_Y ? n : 0)));
+    begin = end;
+  }
+}
+
+#endif
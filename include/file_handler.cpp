@@ -10,6 +10,7 @@
 #include "normalize.h"
 #include "make_feature.h"
 #include "metric.h"
+#include "trace.h"
 #include "Eigen/Eigen"
 
 #include <filesystem>
@@ -19,6 +20,15 @@
 #include <iomanip>
 #include <sstream>
 #include <unordered_set>
+#include <cstdio>
+
+#if _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#endif
 
 #if __cplusplus >= 202002L
 #include <string_view>
@@ -42,6 +52,7 @@ namespace LoadMatrix {
    */
   Eigen::MatrixXd readDataSet(const std::string filepath, const int ROWS, const int COLS)
   {
+    MRL_TRACE_SCOPE("LoadMatrix::readDataSet");
     std::ifstream infile(filepath);
     if (infile.fail()) {
       std::cerr << "cant found " << filepath << '\n';
@@ -80,6 +91,7 @@ namespace LoadMatrix {
    */
   Eigen::VectorXd readLabel(const std::string filepath, const int SIZE)
   {
+    MRL_TRACE_SCOPE("LoadMatrix::readLabel");
     std::ifstream infile(filepath);
     if (infile.fail()) {
       std::cerr << "cant found " << filepath << '\n';
@@ -120,11 +132,57 @@ namespace FileHandler {
   {
     namespace fs = std::filesystem;
 
-    fs::path current = fs::current_path();
+    // the controllers ask for the root for every default path, thus the directories are walked only once
+    static const std::string project_root = [] {
+      fs::path current = fs::current_path();
 
-    while (current.filename().string() != "MRL_LabelTool")
-      current = current.parent_path();
+      while (current.filename().string() != "MRL_LabelTool")
+        current = current.parent_path();
+
+      return current.string();
+    }();
+
+    return project_root;
+  }
+
+  /**
+   * @brief Flush the OS cache of the file to the disk (fsync), so the data survives a crash or a power loss.
+   *
+   * @param filepath The file would be synchronized.
+   */
+  void sync_file(const std::string &filepath)
+  {
+#if _WIN32
+    const int fd = _open(filepath.c_str(), _O_RDWR | _O_BINARY);
+    if (fd == -1) {
+      std::cerr << "cant sync " << filepath << '\n';
+      return;
+    }
+    _commit(fd);
+    _close(fd);
+#else
+    const int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd == -1) {
+      std::cerr << "cant sync " << filepath << '\n';
+      return;
+    }
+    fsync(fd);
+    close(fd);
+#endif
+  }
 
-    return current.string();
+  /**
+   * @brief Flush the buffer of the C stream and the OS cache of the file to the disk (fsync).
+   *
+   * @param file The file would be synchronized.
+   */
+  void sync_file(std::FILE *file)
+  {
+    std::fflush(file);
+#if _WIN32
+    _commit(_fileno(file));
+#else
+    fsync(fileno(file));
+#endif
   }
 }    // namespace FileHandler
\ No newline at end of file
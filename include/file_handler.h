@@ -17,6 +17,7 @@
 #include <iomanip>
 #include <vector>
 #include <sstream>
+#include <cstdio>
 
 
 #if __cplusplus >= 202002L
@@ -66,6 +67,20 @@ namespace FileHandler {
    */
   std::string get_MRL_project_root();
 
+  /**
+   * @brief Flush the OS cache of the file to the disk (fsync), so the data survives a crash or a power loss.
+   *
+   * @param filepath The file would be synchronized.
+   */
+  void sync_file(const std::string &filepath);
+
+  /**
+   * @brief Flush the buffer of the C stream and the OS cache of the file to the disk (fsync).
+   *
+   * @param file The file would be synchronized.
+   */
+  void sync_file(std::FILE *file);
+
   namespace detail {
 #if __cplusplus >= 202002L
     /**
@@ -0,0 +1,180 @@
+/**
+ * @file json_stream_writer.cpp
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The implementation of the streaming JSON writer.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "json_stream_writer.h"
+#include "json.hpp"
+
+#include <array>
+#include <cassert>
+#include <charconv>
+#include <cmath>
+
+void JsonStreamWriter::begin_object()
+{
+  _begin_container('{');
+}
+
+void JsonStreamWriter::end_object()
+{
+  _end_container('}');
+}
+
+void JsonStreamWriter::begin_array()
+{
+  _begin_container('[');
+}
+
+void JsonStreamWriter::end_array()
+{
+  _end_container(']');
+}
+
+/**
+ * @brief Write the key of the next value in the object.
+ *
+ * @param name The key, it's written without escaping, thus it can't contain the quote, the backslash or the control characters.
+ */
+void JsonStreamWriter::key(const std::string_view name)
+{
+  _begin_element();
+
+  _buffer += '"';
+  _buffer += name;
+  _buffer += "\": ";
+  _after_key = true;
+}
+
+void JsonStreamWriter::value(const int number)
+{
+  _begin_element();
+
+  std::array<char, 16> number_buffer;
+  char *end = std::to_chars(number_buffer.data(), number_buffer.data() + number_buffer.size(), number).ptr;
+  _buffer.append(number_buffer.data(), end);
+  _flush_if_full();
+}
+
+/**
+ * @brief Write the floating number, formatted as nlohmann::json does (the shortest round-trip digits, and null for nan and inf).
+ */
+void JsonStreamWriter::value(const double number)
+{
+  _begin_element();
+
+  if (!std::isfinite(number)) {
+    _buffer += "null";
+  }
+  else {
+    std::array<char, 64> number_buffer;
+    char *end = nlohmann::detail::to_chars(number_buffer.data(), number_buffer.data() + number_buffer.size(), number);
+    _buffer.append(number_buffer.data(), end);
+  }
+
+  _flush_if_full();
+}
+
+/**
+ * @brief Continue writing the elements of a container opened by another writer, thus the parts of a container can be written in parallel.
+ *
+ * @param depth The numbers of the containers opened before the elements.
+ * @param empty Whether no element was written in the container before.
+ */
+void JsonStreamWriter::resume(const int depth, const bool empty)
+{
+  assert(depth > 0 && "the elements must be in a container");
+
+  _empty_stack.assign(depth, false);
+  _empty_stack.back() = empty;
+}
+
+/**
+ * @brief Append the elements written by a resumed writer to the current container.
+ *
+ * @param elements The output of the resumed writer.
+ */
+void JsonStreamWriter::append_elements(const std::string_view elements)
+{
+  if (elements.empty())
+    return;
+
+  assert(!_empty_stack.empty() && "the elements must be in a container");
+  _buffer += elements;
+  _empty_stack.back() = false;
+  _flush_if_full();
+}
+
+/**
+ * @brief Write the buffer to the stream if it's full, the rest is written by the destructor.
+ */
+void JsonStreamWriter::_flush_if_full()
+{
+  if (_buffer.size() >= BUFFER_SIZE) {
+    _os.write(_buffer.data(), _buffer.size());
+    _buffer.clear();
+  }
+}
+
+/**
+ * @brief Write the separator and the indent before an element of the container,
+ *        the value after a key is written right after the key.
+ */
+void JsonStreamWriter::_begin_element()
+{
+  if (_after_key) {
+    _after_key = false;
+    return;
+  }
+
+  if (_empty_stack.empty())
+    return;    // the root value
+
+  _buffer += _empty_stack.back() ? "\n" : ",\n";
+  _empty_stack.back() = false;
+  _buffer.append(_empty_stack.size() * _indent, ' ');
+}
+
+void JsonStreamWriter::_begin_container(const char open)
+{
+  _begin_element();
+
+  _buffer += open;
+  _empty_stack.push_back(true);
+}
+
+void JsonStreamWriter::_end_container(const char close)
+{
+  assert(!_empty_stack.empty() && "end_object or end_array without a container opened");
+
+  const bool is_empty = _empty_stack.back();
+  _empty_stack.pop_back();
+
+  // the empty container is written as {} or []
+  if (!is_empty)
+    _newline();
+
+  _buffer += close;
+  _flush_if_full();
+}
+
+void JsonStreamWriter::_newline()
+{
+  _buffer += '\n';
+  _buffer.append(_empty_stack.size() * _indent, ' ');
+}
+
+JsonStreamWriter::JsonStreamWriter(std::ostream &os, const int indent)
+    : _os(os), _indent(indent)
+{
+  _buffer.reserve(BUFFER_SIZE + 256);
+}
+
+JsonStreamWriter::~JsonStreamWriter()
+{
+  _os.write(_buffer.data(), _buffer.size());
+  _os.flush();
+}
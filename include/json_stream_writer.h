@@ -0,0 +1,56 @@
+#ifndef JSON_STREAM_WRITER_H__
+#define JSON_STREAM_WRITER_H__
+
+/**
+ * @file json_stream_writer.h
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The streaming JSON writer. It writes the values to the buffered output while iterating the data,
+ *        so the memory doesn't grow with the data, and the output is the same as `nlohmann::ordered_json::dump(indent)`.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class JsonStreamWriter {
+public:
+  void begin_object();
+  void end_object();
+  void begin_array();
+  void end_array();
+
+  void key(const std::string_view name);
+  void value(const int number);
+  void value(const double number);
+
+  void resume(const int depth, const bool empty);
+  void append_elements(const std::string_view elements);
+
+  explicit JsonStreamWriter(std::ostream &os, const int indent = 2);
+  JsonStreamWriter(const JsonStreamWriter &) = delete;
+  JsonStreamWriter &operator=(const JsonStreamWriter &) = delete;
+  ~JsonStreamWriter();
+
+public:
+  static constexpr std::size_t BUFFER_SIZE = 1 << 16;    // the buffer is written to the stream when it's larger than this
+
+private:
+  void _begin_element();
+  void _begin_container(const char open);
+  void _end_container(const char close);
+  void _newline();
+  void _flush_if_full();
+
+private:
+  std::ostream &_os;
+  std::string _buffer;
+  int _indent;
+
+  std::vector<bool> _empty_stack;    // whether the container has no element yet, one for each opened container
+  bool _after_key = false;    // the next value is the value of a key, thus it's on the same line
+};
+
+#endif
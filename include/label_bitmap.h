@@ -0,0 +1,226 @@
+#ifndef LABEL_BITMAP_H__
+#define LABEL_BITMAP_H__
+
+/**
+ * @file label_bitmap.h
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The bit-packed storage of the labels. The labels of the segments are 0 or 1, thus each label takes one bit,
+ *        and the labeled frames are recorded in a bitmap, so counting and finding them are done 64 frames at a time.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief A fixed-size bitmap, the number of the set bits is cached.
+ */
+class FrameBitmap {
+public:
+  /**
+   * @brief Resize the bitmap, the new bits are 0, the bits out of the new size are dropped.
+   *
+   * @param bit_num The numbers of the bits.
+   */
+  void resize(const int bit_num)
+  {
+    _bit_num = bit_num;
+    _word_vec.resize((bit_num + 63) / 64, 0);
+    if (bit_num % 64 != 0)
+      _word_vec.back() &= (std::uint64_t{ 1 } << (bit_num % 64)) - 1;
+
+    _count = 0;
+    for (const std::uint64_t word : _word_vec)
+      _count += std::popcount(word);
+  }
+
+  void clear()
+  {
+    std::fill(_word_vec.begin(), _word_vec.end(), 0);
+    _count = 0;
+  }
+
+  void set(const int index)
+  {
+    std::uint64_t &word = _word_vec[index / 64];
+    const std::uint64_t mask = std::uint64_t{ 1 } << (index % 64);
+
+    _count += (word & mask) == 0;
+    word |= mask;
+  }
+
+  void reset(const int index)
+  {
+    std::uint64_t &word = _word_vec[index / 64];
+    const std::uint64_t mask = std::uint64_t{ 1 } << (index % 64);
+
+    _count -= (word & mask) != 0;
+    word &= ~mask;
+  }
+
+  bool test(const int index) const { return (_word_vec[index / 64] >> (index % 64)) & 1; }
+
+  int size() const { return _bit_num; }
+  int count() const { return _count; }
+  std::size_t bytes() const { return _word_vec.capacity() * sizeof(std::uint64_t); }
+
+  /**
+   * @brief Find the first set bit in [index, size).
+   *
+   * @return int The index of the bit, -1 if there is no such bit.
+   */
+  int next_set(const int index) const { return _next(index, 0); }
+
+  /**
+   * @brief Find the first unset bit in [index, size).
+   *
+   * @return int The index of the bit, -1 if there is no such bit.
+   */
+  int next_unset(const int index) const { return _next(index, ~std::uint64_t{ 0 }); }
+
+  /**
+   * @brief Find the last set bit.
+   *
+   * @return int The index of the bit, -1 if no bit is set.
+   */
+  int last_set() const
+  {
+    for (int w = static_cast<int>(_word_vec.size()) - 1; w >= 0; --w) {
+      if (_word_vec[w] != 0)
+        return w * 64 + 63 - std::countl_zero(_word_vec[w]);
+    }
+
+    return -1;
+  }
+
+private:
+  /**
+   * @brief Find the first bit in [index, size) which is different from the bits of the flip mask.
+   */
+  int _next(const int index, const std::uint64_t flip) const
+  {
+    if (index < 0 || index >= _bit_num)
+      return -1;
+
+    int w = index / 64;
+    std::uint64_t word = (_word_vec[w] ^ flip) & (~std::uint64_t{ 0 } << (index % 64));
+    while (word == 0) {
+      if (++w == static_cast<int>(_word_vec.size()))
+        return -1;
+
+      word = _word_vec[w] ^ flip;
+    }
+
+    const int result = w * 64 + std::countr_zero(word);
+    return result < _bit_num ? result : -1;
+  }
+
+private:
+  std::vector<std::uint64_t> _word_vec;
+  int _bit_num = 0;
+  int _count = 0;
+};
+
+/**
+ * @brief The labels of all frames, one bit per segment, with a bitmap of the labeled frames.
+ *        The first 64 labels of a frame are stored inline, only the frames with more segments allocate the rest.
+ */
+class PackedLabelTable {
+public:
+  void resize(const int frame_num)
+  {
+    for (auto it = _extra_word_map.begin(); it != _extra_word_map.end();)
+      it = (it->first >= frame_num) ? _extra_word_map.erase(it) : std::next(it);
+
+    _word_vec.resize(frame_num, 0);
+    _segment_num_vec.resize(frame_num, 0);
+    _labeled_frames.resize(frame_num);
+  }
+
+  void clear()
+  {
+    std::fill(_word_vec.begin(), _word_vec.end(), 0);
+    std::fill(_segment_num_vec.begin(), _segment_num_vec.end(), 0);
+    _extra_word_map.clear();
+    _labeled_frames.clear();
+  }
+
+  /**
+   * @brief Set the labels of the frame, a frame without any segment is treated as not labeled.
+   *
+   * @param frame The frame.
+   * @param label The label of each segment, nonzero means labeled.
+   * @param segment_num The numbers of the segments.
+   */
+  void set(const int frame, const int *label, const int segment_num)
+  {
+    _word_vec[frame] = 0;
+    for (int i = 0; i < std::min(segment_num, 64); ++i)
+      _word_vec[frame] |= std::uint64_t{ label[i] != 0 } << i;
+
+    if (segment_num > 64) {
+      std::vector<std::uint64_t> &extra_words = _extra_word_map[frame];
+      extra_words.assign((segment_num - 1) / 64, 0);
+      for (int i = 64; i < segment_num; ++i)
+        extra_words[i / 64 - 1] |= std::uint64_t{ label[i] != 0 } << (i % 64);
+    }
+    else {
+      _extra_word_map.erase(frame);
+    }
+
+    _segment_num_vec[frame] = segment_num;
+    if (segment_num != 0)
+      _labeled_frames.set(frame);
+    else
+      _labeled_frames.reset(frame);
+  }
+
+  /**
+   * @brief Unpack the labels of the frame.
+   *
+   * @param frame The frame.
+   * @param label The label of each segment, it's resized to the numbers of the segments.
+   */
+  void get(const int frame, std::vector<int> &label) const
+  {
+    label.resize(_segment_num_vec[frame]);
+    for (int i = 0; i < _segment_num_vec[frame]; ++i)
+      label[i] = this->label(frame, i);
+  }
+
+  int label(const int frame, const int segment) const
+  {
+    const std::uint64_t word = (segment < 64) ? _word_vec[frame] : _extra_word_map.at(frame)[segment / 64 - 1];
+    return (word >> (segment % 64)) & 1;
+  }
+
+  int segment_num(const int frame) const { return _segment_num_vec[frame]; }
+
+  const FrameBitmap &labeled_frames() const { return _labeled_frames; }
+
+  /**
+   * @brief The memory used by the labels, the bitmap and the per-frame bookkeeping.
+   */
+  std::size_t bytes() const
+  {
+    std::size_t bytes = _word_vec.capacity() * sizeof(std::uint64_t) + _segment_num_vec.capacity() * sizeof(std::uint16_t) + _labeled_frames.bytes();
+    for (const auto &[frame, extra_words] : _extra_word_map)
+      bytes += sizeof(frame) + sizeof(extra_words) + extra_words.capacity() * sizeof(std::uint64_t);
+
+    return bytes;
+  }
+
+private:
+  std::vector<std::uint64_t> _word_vec;    // the first 64 labels of each frame, bit i is the label of segment i
+  std::vector<std::uint16_t> _segment_num_vec;    // the numbers of the segments of each frame, it's less than HZ
+  std::unordered_map<int, std::vector<std::uint64_t>> _extra_word_map;    // the labels after the 64-th segment, only for the frames having more segments
+  FrameBitmap _labeled_frames;
+};
+
+#endif
@@ -0,0 +1,172 @@
+/**
+ * @file label_journal.cpp
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The implementation of the write-ahead journal of the label tool.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "label_journal.h"
+#include "file_handler.h"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+  constexpr std::uint32_t JOURNAL_RECORD_MAGIC = 0x4A4C524D;    // "MRLJ"
+
+  /**
+   * @brief FNV-1a hash, used as the checksum of the record.
+   *
+   * @param hash The hash of the data before.
+   * @param data The data would be hashed.
+   * @param size The bytes of the data.
+   * @return std::uint32_t The hash.
+   */
+  std::uint32_t fnv1a(std::uint32_t hash, const void *data, const int size)
+  {
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+    for (int i = 0; i < size; ++i) {
+      hash ^= bytes[i];
+      hash *= 16777619u;
+    }
+
+    return hash;
+  }
+
+  std::uint32_t record_checksum(const JournalRecordHeader &header, const void *feature, const void *label)
+  {
+    std::uint32_t hash = 2166136261u;
+    hash = fnv1a(hash, &header.frame, sizeof(header.frame));
+    hash = fnv1a(hash, &header.feature_size, sizeof(header.feature_size));
+    hash = fnv1a(hash, &header.label_size, sizeof(header.label_size));
+    hash = fnv1a(hash, feature, header.feature_size);
+    hash = fnv1a(hash, label, header.label_size);
+
+    return hash;
+  }
+}    // namespace
+
+/**
+ * @brief Open the journal, it would be created if it doesn't exist. Call `replay` before appending any record.
+ *
+ * @param journal_path The journal file.
+ * @throw std::runtime_error The journal can't be opened.
+ */
+void LabelJournal::open(const std::string &journal_path)
+{
+  _journal_path = journal_path;
+  if (!std::filesystem::exists(_journal_path)) std::ofstream create_file(_journal_path);    // just for creating file.
+  _bytes = static_cast<std::int64_t>(std::filesystem::file_size(_journal_path));
+
+  _journal_file = std::fopen(_journal_path.c_str(), "ab");
+  if (_journal_file == nullptr)
+    throw std::runtime_error("cant open " + _journal_path);
+}
+
+/**
+ * @brief Apply all the complete records in the journal in order, the incomplete record at the end (killed while writing) would be dropped.
+ *
+ * @param apply The function writing the record into the stores, it must be fine to apply a record more than once.
+ * @return int The numbers of the records applied.
+ * @throw std::runtime_error The journal can't be read.
+ */
+int LabelJournal::replay(const ApplyFunction &apply)
+{
+  std::ifstream infile(_journal_path, std::ios::in | std::ios::binary);
+  if (infile.fail())
+    throw std::runtime_error("cant open " + _journal_path);
+
+  int record_num = 0;
+  std::int64_t valid_end = 0;
+  std::vector<char> data_buf;
+  JournalRecordHeader header;
+
+  while (infile.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+    if (header.magic != JOURNAL_RECORD_MAGIC || header.feature_size < 0 || header.label_size < 0 ||
+        valid_end + static_cast<std::int64_t>(sizeof(header)) + header.feature_size + header.label_size > _bytes)
+      break;
+
+    data_buf.resize(header.feature_size + header.label_size);
+    if (!infile.read(data_buf.data(), data_buf.size()))
+      break;
+
+    const char *feature = data_buf.data();
+    const char *label = data_buf.data() + header.feature_size;
+    if (record_checksum(header, feature, label) != header.checksum)
+      break;
+
+    apply(header.frame, feature, header.feature_size, label, header.label_size);
+    valid_end += sizeof(header) + data_buf.size();
+    ++record_num;
+  }
+  infile.close();
+
+  // drop the incomplete record
+  if (valid_end != _bytes) {
+    std::lock_guard lock(_mutex);
+    std::fflush(_journal_file);
+    std::filesystem::resize_file(_journal_path, valid_end);
+    _bytes = valid_end;
+  }
+
+  return record_num;
+}
+
+/**
+ * @brief Record a save. It returns after the record is written to the OS, it's on the disk after `sync`.
+ *
+ * @param frame The frame would be saved.
+ * @param feature The features of the frame.
+ * @param feature_size The bytes of the features.
+ * @param label The labels of the frame.
+ * @param label_size The bytes of the labels.
+ */
+void LabelJournal::append(const int frame, const void *feature, const int feature_size, const void *label, const int label_size)
+{
+  JournalRecordHeader header{ JOURNAL_RECORD_MAGIC, frame, feature_size, label_size, 0 };
+  header.checksum = record_checksum(header, feature, label);
+
+  {
+    std::lock_guard lock(_mutex);
+    std::fwrite(&header, sizeof(header), 1, _journal_file);
+    std::fwrite(feature, 1, feature_size, _journal_file);
+    std::fwrite(label, 1, label_size, _journal_file);
+    std::fflush(_journal_file);    // a killed process won't lose it, the fsync is done by `sync`.
+
+    _bytes += sizeof(header) + feature_size + label_size;
+  }
+}
+
+/**
+ * @brief Write all the records appended to the disk, the records appended together share the fsync.
+ */
+void LabelJournal::sync()
+{
+  std::lock_guard lock(_mutex);
+  FileHandler::sync_file(_journal_file);
+}
+
+/**
+ * @brief Drop all the records (checkpoint). The stores must have been synchronized to the disk before.
+ */
+void LabelJournal::truncate()
+{
+  std::lock_guard lock(_mutex);
+
+  std::fflush(_journal_file);
+  std::filesystem::resize_file(_journal_path, 0);
+  FileHandler::sync_file(_journal_file);
+
+  _bytes = 0;
+}
+
+LabelJournal::~LabelJournal()
+{
+  if (_journal_file == nullptr)
+    return;
+
+  std::fclose(_journal_file);
+}
@@ -0,0 +1,59 @@
+#ifndef LABEL_JOURNAL_H__
+#define LABEL_JOURNAL_H__
+
+/**
+ * @file label_journal.h
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The write-ahead journal of the label tool. Every label save is recorded in the journal before it's written to the stores,
+ *        so the stores can be rebuilt into a consistent state after a crash.
+ *        The writer thread appends a batch of the saves then synchronizes the journal once (group commit),
+ *        thus the saves queued while the last batch was written only pay one fsync.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+
+/**
+ * @brief The header of a record, followed by the features and the labels of the frame.
+ */
+struct JournalRecordHeader {
+  std::uint32_t magic;
+  int frame;
+  int feature_size;    // the bytes of the features
+  int label_size;    // the bytes of the labels
+  std::uint32_t checksum;    // the checksum of the frame, the sizes and the data, for finding the record which was not completely written
+};
+
+class LabelJournal {
+public:
+  using ApplyFunction = std::function<void(const int frame, const char *feature, const int feature_size, const char *label, const int label_size)>;
+
+  void open(const std::string &journal_path);
+  int replay(const ApplyFunction &apply);
+
+  void append(const int frame, const void *feature, const int feature_size, const void *label, const int label_size);
+  void sync();
+  void truncate();
+
+  std::int64_t bytes() const { return _bytes; }
+  bool is_open() const { return _journal_file != nullptr; }
+
+  LabelJournal() = default;
+  LabelJournal(const LabelJournal &) = delete;
+  LabelJournal &operator=(const LabelJournal &) = delete;
+  ~LabelJournal();
+
+private:
+  std::string _journal_path;
+  std::FILE *_journal_file = nullptr;
+  std::int64_t _bytes = 0;
+
+  std::mutex _mutex;
+};
+
+#endif
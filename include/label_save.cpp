@@ -0,0 +1,64 @@
+/**
+ * @file label_save.cpp
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The implementation of the save path of the label tool.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "label_save.h"
+
+namespace LabelSave {
+  /**
+   * @brief Write a batch of the saves to the journal and the stores.
+   *        The batch is on the disk in the journal before any of it is written to the stores,
+   *        otherwise the OS may write an index slot before the journal record, and a power loss would leave a slot with no record to replay.
+   *        The batch shares one fsync of the journal.
+   *
+   * @param batch The saves would be written, at most one per frame.
+   */
+  void write_batch(LabelJournal &journal, LogStore &feature_store, LogStore &label_store, const std::vector<const LabelSaveRecord *> &batch)
+  {
+    for (const LabelSaveRecord *record : batch)
+      journal.append(record->frame, record->feature.data(), record->feature.size() * sizeof(double), record->label.data(), record->label.size() * sizeof(int));
+    journal.sync();
+
+    // append the data to the end of the log whatever the frame order is.
+    for (const LabelSaveRecord *record : batch) {
+      feature_store.append(record->frame, record->feature.data(), record->feature.size() * sizeof(double));
+      label_store.append(record->frame, record->label.data(), record->label.size() * sizeof(int));
+    }
+
+    if (journal.bytes() > JOURNAL_CHECKPOINT_BYTES)
+      checkpoint(journal, feature_store, label_store);
+  }
+
+  /**
+   * @brief Synchronize the stores to the disk, then the records in the journal are no longer needed.
+   */
+  void checkpoint(LabelJournal &journal, LogStore &feature_store, LogStore &label_store)
+  {
+    feature_store.sync();
+    label_store.sync();
+    journal.truncate();
+  }
+
+  /**
+   * @brief Write the saves in the journal into the stores, which may not reach the stores before the tool was killed.
+   *        The records of the frames out of the stores are skipped.
+   *
+   * @param last_frame The frame of the last record written, it's not changed if no record is written.
+   * @return int The numbers of the records in the journal.
+   */
+  int replay(LabelJournal &journal, LogStore &feature_store, LogStore &label_store, int &last_frame)
+  {
+    return journal.replay([&](const int frame, const char *feature, const int feature_size, const char *label, const int label_size) {
+      if (frame < 0 || frame >= feature_store.frame_num())
+        return;
+
+      feature_store.append(frame, feature, feature_size);
+      label_store.append(frame, label, label_size);
+      last_frame = frame;
+    });
+  }
+}    // namespace LabelSave
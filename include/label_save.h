@@ -0,0 +1,35 @@
+#ifndef LABEL_SAVE_H__
+#define LABEL_SAVE_H__
+
+/**
+ * @file label_save.h
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief Write the label saves to the journal and the stores, it's the save path of the label tool without the GUI.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "label_journal.h"
+#include "log_store.h"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief One label save, it won't be modified after it's pushed to the writer.
+ */
+struct LabelSaveRecord {
+  int frame;
+  std::vector<double> feature;    // the features of the frame, row by row
+  std::vector<int> label;    // the label of each segment in the frame
+};
+
+namespace LabelSave {
+  constexpr std::int64_t JOURNAL_CHECKPOINT_BYTES = 64 << 20;    // checkpoint the stores if the journal is larger than this
+
+  void write_batch(LabelJournal &journal, LogStore &feature_store, LogStore &label_store, const std::vector<const LabelSaveRecord *> &batch);
+  void checkpoint(LabelJournal &journal, LogStore &feature_store, LogStore &label_store);
+  int replay(LabelJournal &journal, LogStore &feature_store, LogStore &label_store, int &last_frame);
+}    // namespace LabelSave
+
+#endif
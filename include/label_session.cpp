@@ -0,0 +1,127 @@
+/**
+ * @file label_session.cpp
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The implementation of reading the label tool's binary stores.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "label_session.h"
+#include "log_store.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+/**
+ * @brief Map the stores of the label tool. The frames which have both the features and the labels are used,
+ *        the row counts come from the index files. The saves still in the journal are not included,
+ *        close the label tool first (it checkpoints at exit).
+ *
+ * @param feature_bin_path The feature log.
+ * @param feature_num_bin_path The index of the feature log.
+ * @param label_bin_path The label log.
+ * @param label_num_bin_path The index of the label log.
+ */
+void LabelSession::open(const std::string &feature_bin_path, const std::string &feature_num_bin_path, const std::string &label_bin_path, const std::string &label_num_bin_path)
+{
+  if (!_feature_file.open(feature_bin_path) || !_label_file.open(label_bin_path)) {
+    std::cin.get();
+    exit(1);
+  }
+
+  // the old feature num file stored the size in a slot of sizeof(double) bytes, and the old label num file used sizeof(int) bytes.
+  std::vector<LogIndexSlot> feature_slot_vec, label_slot_vec;
+  try {
+    feature_slot_vec = LogStore::read_index(feature_num_bin_path, sizeof(double), static_cast<std::int64_t>(_feature_file.size()));
+    label_slot_vec = LogStore::read_index(label_num_bin_path, sizeof(int), static_cast<std::int64_t>(_label_file.size()));
+  }
+  catch (const std::runtime_error &e) {
+    std::cerr << e.what() << '\n';
+    std::cin.get();
+    exit(1);
+  }
+
+  // the labeled frames, the features and the labels of a frame must have the same rows.
+  std::vector<int> frame_vec;
+  const int frame_num = static_cast<int>(std::min(feature_slot_vec.size(), label_slot_vec.size()));
+  for (int i = 0; i < frame_num; ++i) {
+    const int rows = label_slot_vec[i].size / static_cast<int>(sizeof(int));
+    if (rows != 0 && feature_slot_vec[i].size == rows * FEATURE_NUM * static_cast<int>(sizeof(double)))
+      frame_vec.push_back(i);
+  }
+
+  _frame_num = static_cast<int>(frame_vec.size());
+  _segment_num = 0;
+  _feature_buf.clear();
+  _label_buf.clear();
+
+  // check if the records are contiguous in both logs
+  bool contiguous = true;
+  for (std::size_t f = 1; f < frame_vec.size(); ++f) {
+    const LogIndexSlot &prev_feature = feature_slot_vec[frame_vec[f - 1]], &prev_label = label_slot_vec[frame_vec[f - 1]];
+    if (feature_slot_vec[frame_vec[f]].offset != prev_feature.offset + prev_feature.size || label_slot_vec[frame_vec[f]].offset != prev_label.offset + prev_label.size) {
+      contiguous = false;
+      break;
+    }
+  }
+
+  for (const int i : frame_vec)
+    _segment_num += label_slot_vec[i].size / sizeof(int);
+
+  if (frame_vec.empty()) {
+    _feature_data = nullptr;
+    _label_data = nullptr;
+  }
+  else if (contiguous) {
+    // zero copy, the maps point into the mapped logs (the records are aligned since every record is a multiple of the element size)
+    _feature_data = reinterpret_cast<const double *>(_feature_file.data() + feature_slot_vec[frame_vec.front()].offset);
+    _label_data = reinterpret_cast<const int *>(_label_file.data() + label_slot_vec[frame_vec.front()].offset);
+  }
+  else {
+    // the log has overwritten records, gather the latest records in frame order
+    _feature_buf.resize(static_cast<std::size_t>(_segment_num) * FEATURE_NUM);
+    _label_buf.resize(_segment_num);
+
+    std::size_t row = 0;
+    for (const int i : frame_vec) {
+      const int rows = label_slot_vec[i].size / sizeof(int);
+      std::memcpy(_feature_buf.data() + row * FEATURE_NUM, _feature_file.data() + feature_slot_vec[i].offset, feature_slot_vec[i].size);
+      std::memcpy(_label_buf.data() + row, _label_file.data() + label_slot_vec[i].offset, label_slot_vec[i].size);
+      row += rows;
+    }
+
+    _feature_data = _feature_buf.data();
+    _label_data = _label_buf.data();
+  }
+}
+
+/**
+ * @brief Open the stores listed in the tool data file of the label tool (MesToolLabelController.dat).
+ *
+ * @param tool_data_path The tool data file.
+ */
+void LabelSession::open_tool_data(const std::string &tool_data_path)
+{
+  std::ifstream infile(tool_data_path);
+  if (infile.fail()) {
+    std::cerr << "cant open " << tool_data_path << '\n';
+    std::cin.get();
+    exit(1);
+  }
+
+  // raw_data_path, _raw_bin_path, feature_output_path, label_output_path, then the stores
+  std::string line;
+  for (int i = 0; i < 4; ++i)
+    std::getline(infile, line);
+
+  std::string feature_bin_path, feature_num_bin_path, label_bin_path, label_num_bin_path;
+  std::getline(infile, feature_bin_path);
+  std::getline(infile, feature_num_bin_path);
+  std::getline(infile, label_bin_path);
+  std::getline(infile, label_num_bin_path);
+
+  open(feature_bin_path, feature_num_bin_path, label_bin_path, label_num_bin_path);
+}
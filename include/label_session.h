@@ -0,0 +1,50 @@
+#ifndef LABEL_SESSION_H__
+#define LABEL_SESSION_H__
+
+/**
+ * @file label_session.h
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief Read the features and the labels saved by the label tool from its binary stores, without the text export.
+ *        The logs are memory mapped, and if the records are in frame order without any gap (the compacted store),
+ *        the features and the labels are used in place by the Eigen maps, i.e. no parsing and no copying.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "mapped_file.h"
+#include "make_feature.h"
+#include "Eigen/Eigen"
+
+#include <string>
+#include <vector>
+
+class LabelSession {
+public:
+  using FeatureMatrix = Eigen::Matrix<double, Eigen::Dynamic, FEATURE_NUM, Eigen::RowMajor>;
+  using FeatureMap = Eigen::Map<const FeatureMatrix>;
+  using LabelMap = Eigen::Map<const Eigen::VectorXi>;
+
+  void open(const std::string &feature_bin_path, const std::string &feature_num_bin_path, const std::string &label_bin_path, const std::string &label_num_bin_path);
+  void open_tool_data(const std::string &tool_data_path);
+
+  FeatureMap features() const { return FeatureMap(_feature_data, _segment_num, FEATURE_NUM); }    // one row per segment
+  LabelMap labels() const { return LabelMap(_label_data, _segment_num); }    // the label of each segment
+
+  int segment_num() const { return _segment_num; }
+  int frame_num() const { return _frame_num; }
+  bool is_zero_copy() const { return _feature_buf.empty() && _label_buf.empty(); }
+
+private:
+  MappedFile _feature_file;
+  MappedFile _label_file;
+
+  const double *_feature_data = nullptr;
+  const int *_label_data = nullptr;
+  int _segment_num = 0;    // the numbers of the segments in the labeled frames
+  int _frame_num = 0;    // the numbers of the labeled frames
+
+  std::vector<double> _feature_buf;    // the gathered features if the records are not contiguous
+  std::vector<int> _label_buf;    // the gathered labels if the records are not contiguous
+};
+
+#endif
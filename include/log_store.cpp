@@ -0,0 +1,460 @@
+/**
+ * @file log_store.cpp
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The implementation of the append-only binary store.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "log_store.h"
+#include "file_handler.h"
+#include "task_scheduler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+  constexpr char LOG_INDEX_MAGIC[8] = "MRLIDX2";    // the header of the index file
+  constexpr char LOG_INDEX_V1_MAGIC[8] = "MRLIDX1";    // the header of the index file with 32-bit offsets
+  constexpr int LOG_INDEX_HEADER_SIZE = sizeof(LOG_INDEX_MAGIC);
+  constexpr int COMPACT_MIN_DEAD_BYTES = 1 << 16;    // don't compact the log for a few overwritten records
+
+  /**
+   * @brief Clear the compacting flag when the compaction leaves the scope, including by an exception.
+   */
+  struct CompactingReset {
+    std::atomic<bool> &compacting;
+    ~CompactingReset() { compacting = false; }
+  };
+
+  /**
+   * @brief Write the header and all the slots of the index.
+   *
+   * @param outfile The index file.
+   * @param slot_vec The slot of each frame.
+   */
+  void write_index(std::ostream &outfile, const std::vector<LogIndexSlot> &slot_vec)
+  {
+    outfile.seekp(0, std::ios::beg);
+    outfile.write(LOG_INDEX_MAGIC, LOG_INDEX_HEADER_SIZE);
+    outfile.write(reinterpret_cast<const char *>(slot_vec.data()), slot_vec.size() * sizeof(LogIndexSlot));
+    outfile.flush();
+  }
+}    // namespace
+
+/**
+ * @brief Open the log file and the index file, the files would be created if they don't exist.
+ *        If the index file is in an old format (only the size of each frame, or the 32-bit offsets), it would be converted to the new one.
+ *
+ * @param log_path The log file, which stores the records.
+ * @param index_path The index file, which stores the position of the latest record of each frame.
+ * @param frame_num The numbers of the frames.
+ * @param legacy_slot_size The bytes of each slot in the old index file, the size is stored in the first int of the slot.
+ * @throw std::runtime_error The files can't be opened.
+ */
+void LogStore::open(const std::string &log_path, const std::string &index_path, const int frame_num, const int legacy_slot_size)
+{
+  wait_compaction();
+
+  _log_path = log_path;
+  _index_path = index_path;
+  _compact_log_path = log_path + ".compact";
+  _compact_index_path = index_path + ".compact";
+
+  // the compaction was killed, if the log had been replaced, the compacted index is the one matching the log.
+  if (std::filesystem::exists(_compact_log_path)) {
+    std::filesystem::remove(_compact_log_path);
+    std::filesystem::remove(_compact_index_path);
+  }
+  else if (std::filesystem::exists(_compact_index_path)) {
+    std::filesystem::rename(_compact_index_path, _index_path);
+  }
+
+  if (!std::filesystem::exists(_log_path)) std::ofstream create_file(_log_path);    // just for creating file.
+  if (!std::filesystem::exists(_index_path)) std::ofstream create_file(_index_path);    // just for creating file.
+
+  _log_end = static_cast<std::int64_t>(std::filesystem::file_size(_log_path));
+  _slot_vec.assign(frame_num, LogIndexSlot{ 0, 0 });
+  _load_index(legacy_slot_size);
+
+  _live_bytes = 0;
+  for (const LogIndexSlot &slot : _slot_vec)
+    _live_bytes += slot.size;
+
+  _open_files();
+}
+
+/**
+ * @brief Read all the slots in the index file without changing it, thus the stores can be read by another program.
+ *
+ * @param index_path The index file, in the current format or the old ones.
+ * @param legacy_slot_size The bytes of each slot in the old index file.
+ * @param log_bytes The bytes of the log file, the slot pointing out of it is dropped (the record was not completely written).
+ * @return std::vector<LogIndexSlot> The slot of each frame.
+ * @throw std::runtime_error The index file can't be opened.
+ */
+std::vector<LogIndexSlot> LogStore::read_index(const std::string &index_path, const int legacy_slot_size, const std::int64_t log_bytes)
+{
+  std::ifstream infile(index_path, std::ios::in | std::ios::binary);
+  if (infile.fail())
+    throw std::runtime_error("cant open " + index_path);
+
+  const std::int64_t index_bytes = static_cast<std::int64_t>(std::filesystem::file_size(index_path));
+  std::vector<LogIndexSlot> slot_vec;
+
+  char magic[LOG_INDEX_HEADER_SIZE] = {};
+  infile.read(magic, LOG_INDEX_HEADER_SIZE);
+  if (infile && std::memcmp(magic, LOG_INDEX_MAGIC, LOG_INDEX_HEADER_SIZE) == 0) {
+    slot_vec.resize((index_bytes - LOG_INDEX_HEADER_SIZE) / sizeof(LogIndexSlot));
+    infile.read(reinterpret_cast<char *>(slot_vec.data()), slot_vec.size() * sizeof(LogIndexSlot));
+  }
+  else if (infile && std::memcmp(magic, LOG_INDEX_V1_MAGIC, LOG_INDEX_HEADER_SIZE) == 0) {
+    // the first version, the slot was { int offset, int size }.
+    std::vector<int> v1_slot_vec((index_bytes - LOG_INDEX_HEADER_SIZE) / sizeof(int) / 2 * 2);
+    infile.read(reinterpret_cast<char *>(v1_slot_vec.data()), v1_slot_vec.size() * sizeof(int));
+
+    slot_vec.resize(v1_slot_vec.size() / 2);
+    for (std::size_t i = 0; i < slot_vec.size(); ++i)
+      slot_vec[i] = { v1_slot_vec[2 * i], v1_slot_vec[2 * i + 1] };
+  }
+  else {
+    // the old format, the records were stored in frame order without any gap, thus the offset is the prefix sum of the sizes.
+    infile.clear();
+    infile.seekg(0, std::ios::beg);
+
+    slot_vec.resize(index_bytes / legacy_slot_size);
+    std::vector<char> slot_buf(std::max<int>(legacy_slot_size, sizeof(int)));
+    std::int64_t offset = 0;
+    for (auto &slot : slot_vec) {
+      infile.read(slot_buf.data(), legacy_slot_size);
+
+      int size;
+      std::memcpy(&size, slot_buf.data(), sizeof(int));
+      slot = { offset, size };
+      offset += size;
+    }
+  }
+
+  // drop the record which was not completely written.
+  for (auto &slot : slot_vec) {
+    if (slot.size < 0 || slot.offset < 0 || slot.offset + slot.size > log_bytes)
+      slot = { 0, 0 };
+  }
+
+  return slot_vec;
+}
+
+/**
+ * @brief Read the index file into the slot vector, then rewrite it in the current format.
+ *
+ * @param legacy_slot_size The bytes of each slot in the old index file.
+ */
+void LogStore::_load_index(const int legacy_slot_size)
+{
+  const std::vector<LogIndexSlot> file_slot_vec = read_index(_index_path, legacy_slot_size, _log_end);
+  std::copy_n(file_slot_vec.begin(), std::min(file_slot_vec.size(), _slot_vec.size()), _slot_vec.begin());
+
+  std::ofstream outfile(_index_path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (outfile.fail())
+    throw std::runtime_error("cant open " + _index_path);
+  write_index(outfile, _slot_vec);
+}
+
+/**
+ * @brief Open the file stream of the log file and the index file.
+ */
+void LogStore::_open_files()
+{
+  _log_file.open(_log_path, std::ios::in | std::ios::out | std::ios::binary);
+  if (_log_file.fail())
+    throw std::runtime_error("cant open " + _log_path);
+
+  _index_file.open(_index_path, std::ios::in | std::ios::out | std::ios::binary);
+  if (_index_file.fail())
+    throw std::runtime_error("cant open " + _index_path);
+}
+
+/**
+ * @brief Write the slot of the frame into the index file.
+ *
+ * @param frame The frame would be written.
+ */
+void LogStore::_write_index_slot(const int frame)
+{
+  _index_file.seekp(LOG_INDEX_HEADER_SIZE + static_cast<std::streamoff>(frame) * sizeof(LogIndexSlot), std::ios::beg);
+  _index_file.write(reinterpret_cast<const char *>(&_slot_vec[frame]), sizeof(LogIndexSlot));
+  _index_file.flush();
+}
+
+/**
+ * @brief Append the record of the frame to the end of the log, and point the index of the frame to it.
+ *        The old record of the frame becomes garbage, which would be dropped by the compaction.
+ *
+ * @param frame The frame of the record.
+ * @param data The record.
+ * @param size The bytes of the record.
+ */
+void LogStore::append(const int frame, const void *data, const int size)
+{
+  bool need_compaction;
+  {
+    std::lock_guard lock(_mutex);
+
+    _log_file.seekp(_log_end, std::ios::beg);
+    _log_file.write(reinterpret_cast<const char *>(data), size);
+    _log_file.flush();
+
+    _live_bytes += size - _slot_vec[frame].size;
+    _slot_vec[frame] = { _log_end, size };
+    _log_end += size;
+    _write_index_slot(frame);
+
+    const std::int64_t dead_bytes = _log_end - _live_bytes;
+    need_compaction = dead_bytes > COMPACT_MIN_DEAD_BYTES && dead_bytes > _live_bytes;
+  }
+
+  if (need_compaction)
+    compact_async();
+}
+
+/**
+ * @brief Read the latest record of the frame.
+ *
+ * @param frame The frame would be read.
+ * @param data The buffer, it must have at least `size(frame)` bytes.
+ * @return true if the frame has been written, otherwise false.
+ */
+bool LogStore::read(const int frame, void *data)
+{
+  std::lock_guard lock(_mutex);
+  return _read(frame, data);
+}
+
+/**
+ * @brief Read the latest record of the frame, the mutex must be locked.
+ */
+bool LogStore::_read(const int frame, void *data)
+{
+  const LogIndexSlot &slot = _slot_vec[frame];
+  if (slot.size == 0)
+    return false;
+
+  _log_file.seekg(slot.offset, std::ios::beg);
+  _log_file.read(reinterpret_cast<char *>(data), slot.size);
+  _log_file.clear();
+
+  return true;
+}
+
+/**
+ * @brief Remove all the records.
+ */
+void LogStore::clear()
+{
+  wait_compaction();
+  std::lock_guard lock(_mutex);
+
+  _log_file.seekg(0, std::ios::beg);
+  _log_file.seekp(0, std::ios::beg);
+  std::filesystem::resize_file(_log_path, 0);
+  _log_end = 0;
+
+  std::fill(_slot_vec.begin(), _slot_vec.end(), LogIndexSlot{ 0, 0 });
+  _live_bytes = 0;
+  write_index(_index_file, _slot_vec);
+}
+
+/**
+ * @brief Change the numbers of the frames, the new frames have not been written.
+ *
+ * @param frame_num The numbers of the frames.
+ */
+void LogStore::resize(const int frame_num)
+{
+  wait_compaction();
+  std::lock_guard lock(_mutex);
+
+  _slot_vec.resize(frame_num, LogIndexSlot{ 0, 0 });
+  _slot_vec.shrink_to_fit();
+  _live_bytes = 0;
+  for (const LogIndexSlot &slot : _slot_vec)
+    _live_bytes += slot.size;
+
+  std::filesystem::resize_file(_index_path, 0);
+  write_index(_index_file, _slot_vec);
+}
+
+/**
+ * @brief Flush the log file and the index file to the disk.
+ */
+void LogStore::sync()
+{
+  std::lock_guard lock(_mutex);
+
+  _log_file.flush();
+  _index_file.flush();
+  FileHandler::sync_file(_log_path);
+  FileHandler::sync_file(_index_path);
+}
+
+/**
+ * @brief Check if the records are in frame order without any garbage, i.e. the same layout as the old store.
+ */
+bool LogStore::is_compact() const
+{
+  std::int64_t offset = 0;
+  for (const LogIndexSlot &slot : _slot_vec) {
+    if (slot.size != 0 && slot.offset != offset)
+      return false;
+
+    offset += slot.size;
+  }
+
+  return offset == _log_end;
+}
+
+/**
+ * @brief Compact the log and wait until it's done.
+ */
+void LogStore::compact()
+{
+  // a background compaction may start between the wait and the exchange, then wait for it again
+  do {
+    wait_compaction();
+  } while (_compacting.exchange(true));
+
+  CompactingReset reset{ _compacting };
+  _compact_impl();
+}
+
+/**
+ * @brief Compact the log in the background, do nothing if the compaction is running.
+ */
+void LogStore::compact_async()
+{
+  if (_compacting.exchange(true))
+    return;
+
+  std::lock_guard lock(_compact_mutex);
+  if (_compact_future.valid())
+    _compact_future.get();    // the last compaction had finished
+
+  _compact_future = TaskScheduler::instance().submit([this] {
+    CompactingReset reset{ _compacting };
+    try {
+      _compact_impl();
+    }
+    catch (const std::exception &e) {
+      std::cerr << "compaction of " << _log_path << " failed: " << e.what() << '\n';
+    }
+  });
+}
+
+/**
+ * @brief Wait for the background compaction, it may be called by any thread.
+ */
+void LogStore::wait_compaction()
+{
+  std::lock_guard lock(_compact_mutex);
+  if (_compact_future.valid())
+    _compact_future.get();
+}
+
+/**
+ * @brief Rewrite the latest record of each frame into a new log in frame order, then replace the old log.
+ *        The copy runs without holding the lock, so the frames can still be saved while compacting,
+ *        the records appended during the copy are moved to the new log at the end.
+ */
+void LogStore::_compact_impl()
+{
+  std::vector<LogIndexSlot> snapshot_vec;
+  {
+    std::lock_guard lock(_mutex);
+    snapshot_vec = _slot_vec;
+  }
+
+  std::vector<LogIndexSlot> compact_vec(snapshot_vec.size(), LogIndexSlot{ 0, 0 });
+  std::vector<char> record_buf;
+  std::int64_t compact_end = 0;
+
+  std::ofstream compact_log_file(_compact_log_path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (compact_log_file.fail()) {
+    std::cerr << "cant open " << _compact_log_path << '\n';
+    return;
+  }
+
+  {
+    // the records before the snapshot won't be modified, read them by another stream.
+    std::ifstream log_file(_log_path, std::ios::in | std::ios::binary);
+    if (log_file.fail()) {
+      std::cerr << "cant open " << _log_path << '\n';
+      return;
+    }
+
+    for (int i = 0; i < static_cast<int>(snapshot_vec.size()); ++i) {
+      const LogIndexSlot &slot = snapshot_vec[i];
+      if (slot.size == 0)
+        continue;
+
+      record_buf.resize(slot.size);
+      log_file.seekg(slot.offset, std::ios::beg);
+      log_file.read(record_buf.data(), slot.size);
+      compact_log_file.write(record_buf.data(), slot.size);
+
+      compact_vec[i] = { compact_end, slot.size };
+      compact_end += slot.size;
+    }
+  }
+
+  std::lock_guard lock(_mutex);
+
+  // move the records saved during the copy
+  for (int i = 0; i < static_cast<int>(_slot_vec.size()); ++i) {
+    const LogIndexSlot &slot = _slot_vec[i];
+    if (slot.offset == snapshot_vec[i].offset && slot.size == snapshot_vec[i].size)
+      continue;
+
+    record_buf.resize(slot.size);
+    _log_file.seekg(slot.offset, std::ios::beg);
+    _log_file.read(record_buf.data(), slot.size);
+    _log_file.clear();
+    compact_log_file.write(record_buf.data(), slot.size);
+
+    compact_vec[i] = { compact_end, slot.size };
+    compact_end += slot.size;
+  }
+  compact_log_file.close();
+
+  {
+    std::ofstream compact_index_file(_compact_index_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (compact_index_file.fail()) {
+      std::cerr << "cant open " << _compact_index_path << '\n';
+      std::filesystem::remove(_compact_log_path);
+      return;
+    }
+    write_index(compact_index_file, compact_vec);
+  }
+
+  // the new files must be on the disk before they replace the old ones.
+  FileHandler::sync_file(_compact_log_path);
+  FileHandler::sync_file(_compact_index_path);
+
+  // replace the log first, if it was killed between the two renames, `open` would finish the index.
+  _log_file.close();
+  _index_file.close();
+  std::filesystem::rename(_compact_log_path, _log_path);
+  std::filesystem::rename(_compact_index_path, _index_path);
+
+  _slot_vec = std::move(compact_vec);
+  _log_end = compact_end;
+  _open_files();
+}
+
+LogStore::~LogStore()
+{
+  wait_compaction();
+}
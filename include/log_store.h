@@ -0,0 +1,106 @@
+#ifndef LOG_STORE_H__
+#define LOG_STORE_H__
+
+/**
+ * @file log_store.h
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The append-only binary store of the label tool. Every save of a frame is appended to the end of the log file,
+ *        and a per-frame index file points to the latest record of the frame, thus a save is O(1) I/O whatever the frame order is.
+ *        The records which had been overwritten are dropped by the compaction, which runs in the background.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <future>
+#include <vector>
+
+/**
+ * @brief The index file is a header followed by one slot per frame.
+ *        The old index file (before the log store) had no header, and only the size of each frame was stored in the slot.
+ *        The first version of the log store used 32-bit offsets, it's converted when it's opened.
+ */
+struct LogIndexSlot {
+  std::int64_t offset;    // the position of the latest record of the frame in the log file
+  int size;    // the bytes of the record, 0 means the frame has not been written
+  int reserved = 0;    // always 0, so the slot has no uninitialized padding in the file
+};
+
+class LogStore {
+public:
+  void open(const std::string &log_path, const std::string &index_path, const int frame_num, const int legacy_slot_size);
+
+  void append(const int frame, const void *data, const int size);
+  bool read(const int frame, void *data);
+  template <typename T>
+  bool read(const int frame, std::vector<T> &data);
+  void clear();
+  void resize(const int frame_num);
+  void sync();
+
+  void compact();
+  void compact_async();
+  void wait_compaction();
+
+  int size(const int frame) const { return _slot_vec[frame].size; }
+  std::int64_t offset(const int frame) const { return _slot_vec[frame].offset; }
+  int frame_num() const { return static_cast<int>(_slot_vec.size()); }
+  std::int64_t live_bytes() const { return _live_bytes; }
+  std::int64_t log_bytes() const { return _log_end; }
+  bool is_compact() const;
+
+  static std::vector<LogIndexSlot> read_index(const std::string &index_path, const int legacy_slot_size, const std::int64_t log_bytes);
+
+  LogStore() = default;
+  LogStore(const LogStore &) = delete;
+  LogStore &operator=(const LogStore &) = delete;
+  ~LogStore();
+
+private:
+  void _open_files();
+  void _load_index(const int legacy_slot_size);
+  void _write_index_slot(const int frame);
+  void _compact_impl();
+  bool _read(const int frame, void *data);
+
+private:
+  std::string _log_path;
+  std::string _index_path;
+  std::string _compact_log_path;
+  std::string _compact_index_path;
+
+  std::fstream _log_file;
+  std::fstream _index_file;
+
+  std::vector<LogIndexSlot> _slot_vec;
+  std::int64_t _live_bytes = 0;    // the sum of the sizes of the latest records, the log has no garbage if it equals `_log_end`
+  std::int64_t _log_end = 0;
+
+  std::mutex _mutex;    // guard the files and the index when the compaction is running
+  std::mutex _compact_mutex;    // guard the future, the writer thread starts the compaction and the UI thread waits for it
+  std::future<void> _compact_future;
+  std::atomic<bool> _compacting = false;
+};
+
+/**
+ * @brief Read the latest record of the frame, the size is taken in the same lock,
+ *        thus it's safe when another thread is appending the frame.
+ *
+ * @param frame The frame would be read.
+ * @param data The buffer, it's resized to the numbers of the elements in the record.
+ * @return true if the frame has been written, otherwise false.
+ */
+template <typename T>
+bool LogStore::read(const int frame, std::vector<T> &data)
+{
+  std::lock_guard lock(_mutex);
+
+  data.resize(_slot_vec[frame].size / sizeof(T));
+  return _read(frame, data.data());
+}
+
+#endif
@@ -8,6 +8,7 @@
 
 #include "make_feature.h"
 #include "metric.h"
+#include "profiler.h"
 #include "Eigen/Eigen"
 
 #include <vector>
@@ -156,6 +157,7 @@ namespace MakeFeatures {
    */
   Eigen::MatrixXd segment_to_feature(const std::vector<Eigen::MatrixXd> &section_seg_vec)
   {
+    ScopedProfile profile(ProfileStage::segment_to_feature);
     Eigen::MatrixXd feature_data(section_seg_vec.size(), FEATURE_NUM);
     for (int i{}; i < static_cast<int>(section_seg_vec.size()); ++i)
       feature_data.row(i) = make_feature(section_seg_vec[i]);
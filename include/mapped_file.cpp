@@ -0,0 +1,243 @@
+/**
+ * @file mapped_file.cpp
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The implementation of the read-only memory mapped file and the sliding window mapping.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Map the whole file into the memory.
+ *
+ * @param filepath The file would be mapped.
+ * @return true if it's mapped (an empty file is mapped to nullptr with size 0), otherwise false.
+ */
+bool MappedFile::open(const std::string &filepath)
+{
+  close();
+
+  if (!std::filesystem::exists(filepath)) {
+    std::cerr << "cant open " << filepath << '\n';
+    return false;
+  }
+
+  _size = static_cast<std::size_t>(std::filesystem::file_size(filepath));
+  if (_size == 0)
+    return true;    // the empty file can't be mapped
+
+#ifdef _WIN32
+  _file_handle = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (_file_handle == INVALID_HANDLE_VALUE) {
+    _file_handle = nullptr;
+    std::cerr << "cant open " << filepath << '\n';
+    return false;
+  }
+
+  _mapping_handle = CreateFileMappingA(_file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (_mapping_handle != nullptr)
+    _data = static_cast<const char *>(MapViewOfFile(_mapping_handle, FILE_MAP_READ, 0, 0, 0));
+#else
+  const int fd = ::open(filepath.c_str(), O_RDONLY);
+  if (fd == -1) {
+    std::cerr << "cant open " << filepath << '\n';
+    return false;
+  }
+
+  void *data = mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);    // the mapping keeps the file
+  if (data != MAP_FAILED)
+    _data = static_cast<const char *>(data);
+#endif
+
+  if (_data == nullptr) {
+    std::cerr << "cant map " << filepath << '\n';
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+  if (_data != nullptr)
+    UnmapViewOfFile(_data);
+  if (_mapping_handle != nullptr)
+    CloseHandle(_mapping_handle);
+  if (_file_handle != nullptr)
+    CloseHandle(_file_handle);
+
+  _mapping_handle = nullptr;
+  _file_handle = nullptr;
+#else
+  if (_data != nullptr)
+    munmap(const_cast<char *>(_data), _size);
+#endif
+
+  _data = nullptr;
+  _size = 0;
+}
+
+MappedFile::~MappedFile()
+{
+  close();
+}
+
+namespace {
+  /**
+   * @brief The offset of a mapping must be a multiple of it.
+   */
+  std::int64_t allocation_granularity()
+  {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwAllocationGranularity;
+#else
+    return sysconf(_SC_PAGESIZE);
+#endif
+  }
+}    // namespace
+
+/**
+ * @brief Open the file, nothing is mapped until `map` is called.
+ *
+ * @param filepath The file would be mapped.
+ * @param window_bytes The bytes mapped at a time, a larger range is mapped if a single request needs it.
+ * @return true if it's opened, otherwise false.
+ */
+bool MappedWindow::open(const std::string &filepath, const std::int64_t window_bytes)
+{
+  close();
+
+  if (!std::filesystem::exists(filepath)) {
+    std::cerr << "cant open " << filepath << '\n';
+    return false;
+  }
+
+  _file_size = static_cast<std::int64_t>(std::filesystem::file_size(filepath));
+  _window_bytes = window_bytes;
+
+#ifdef _WIN32
+  _file_handle = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (_file_handle == INVALID_HANDLE_VALUE) {
+    _file_handle = nullptr;
+    std::cerr << "cant open " << filepath << '\n';
+    return false;
+  }
+
+  if (_file_size != 0)
+    _mapping_handle = CreateFileMappingA(_file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (_file_size != 0 && _mapping_handle == nullptr) {
+    std::cerr << "cant map " << filepath << '\n';
+    close();
+    return false;
+  }
+#else
+  _fd = ::open(filepath.c_str(), O_RDONLY);
+  if (_fd == -1) {
+    std::cerr << "cant open " << filepath << '\n';
+    return false;
+  }
+#endif
+
+  return true;
+}
+
+/**
+ * @brief Map the range of the file, the window is moved if the range is out of it.
+ *
+ * @param offset The position of the range in the file.
+ * @param bytes The bytes of the range.
+ * @return const char* The data of the range, nullptr if the range is out of the file.
+ */
+const char *MappedWindow::map(const std::int64_t offset, const std::int64_t bytes)
+{
+  if (offset < 0 || bytes <= 0 || offset + bytes > _file_size)
+    return nullptr;
+
+  if (_view != nullptr && offset >= _view_offset && offset + bytes <= _view_offset + _view_bytes)
+    return _view + (offset - _view_offset);
+
+  _unmap();
+
+  const std::int64_t granularity = allocation_granularity();
+  _view_offset = offset / granularity * granularity;
+  _view_bytes = std::min(std::max(_window_bytes, offset + bytes - _view_offset), _file_size - _view_offset);
+
+#ifdef _WIN32
+  _view = static_cast<const char *>(MapViewOfFile(_mapping_handle, FILE_MAP_READ, static_cast<DWORD>(_view_offset >> 32),
+                                                  static_cast<DWORD>(_view_offset & 0xFFFFFFFF), static_cast<SIZE_T>(_view_bytes)));
+#else
+  void *view = mmap(nullptr, static_cast<std::size_t>(_view_bytes), PROT_READ, MAP_SHARED, _fd, static_cast<off_t>(_view_offset));
+  _view = (view != MAP_FAILED) ? static_cast<const char *>(view) : nullptr;
+#endif
+
+  if (_view == nullptr) {
+    _view_bytes = 0;
+    return nullptr;
+  }
+
+  return _view + (offset - _view_offset);
+}
+
+/**
+ * @brief Unmap the current window.
+ */
+void MappedWindow::_unmap()
+{
+#ifdef _WIN32
+  if (_view != nullptr)
+    UnmapViewOfFile(_view);
+#else
+  if (_view != nullptr)
+    munmap(const_cast<char *>(_view), static_cast<std::size_t>(_view_bytes));
+#endif
+
+  _view = nullptr;
+  _view_offset = 0;
+  _view_bytes = 0;
+}
+
+void MappedWindow::close()
+{
+  _unmap();
+
+#ifdef _WIN32
+  if (_mapping_handle != nullptr)
+    CloseHandle(_mapping_handle);
+  if (_file_handle != nullptr)
+    CloseHandle(_file_handle);
+
+  _mapping_handle = nullptr;
+  _file_handle = nullptr;
+#else
+  if (_fd != -1)
+    ::close(_fd);
+
+  _fd = -1;
+#endif
+
+  _file_size = 0;
+}
+
+MappedWindow::~MappedWindow()
+{
+  close();
+}
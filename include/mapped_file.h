@@ -0,0 +1,79 @@
+#ifndef MAPPED_FILE_H__
+#define MAPPED_FILE_H__
+
+/**
+ * @file mapped_file.h
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The read-only memory mapped file, the data is paged in by the OS when it's accessed, without copying into a buffer.
+ *        The whole file is mapped by `MappedFile`, and only a sliding window of it is mapped by `MappedWindow`.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class MappedFile {
+public:
+  bool open(const std::string &filepath);
+  void close();
+
+  const char *data() const { return _data; }
+  std::size_t size() const { return _size; }
+
+  MappedFile() = default;
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  ~MappedFile();
+
+private:
+  const char *_data = nullptr;
+  std::size_t _size = 0;
+
+#ifdef _WIN32
+  void *_file_handle = nullptr;
+  void *_mapping_handle = nullptr;
+#endif
+};
+
+/**
+ * @brief The read-only mapping of a part of the file, the window slides to the requested range when it's out of the window,
+ *        thus the file larger than the address space (or the memory) can be read without mapping the whole file.
+ *        The pointer returned by `map` is invalidated by the next `map` or `close`.
+ */
+class MappedWindow {
+public:
+  bool open(const std::string &filepath, const std::int64_t window_bytes = DEFAULT_WINDOW_BYTES);
+  void close();
+  const char *map(const std::int64_t offset, const std::int64_t bytes);
+
+  std::int64_t file_size() const { return _file_size; }
+
+  MappedWindow() = default;
+  MappedWindow(const MappedWindow &) = delete;
+  MappedWindow &operator=(const MappedWindow &) = delete;
+  ~MappedWindow();
+
+public:
+  static constexpr std::int64_t DEFAULT_WINDOW_BYTES = std::int64_t{ 64 } << 20;
+
+private:
+  void _unmap();
+
+private:
+  const char *_view = nullptr;
+  std::int64_t _view_offset = 0;    // the position of the view in the file, aligned to the allocation granularity
+  std::int64_t _view_bytes = 0;
+  std::int64_t _window_bytes = DEFAULT_WINDOW_BYTES;
+  std::int64_t _file_size = 0;
+
+#ifdef _WIN32
+  void *_file_handle = nullptr;
+  void *_mapping_handle = nullptr;
+#else
+  int _fd = -1;
+#endif
+};
+
+#endif
@@ -7,6 +7,7 @@
  */
 
 #include "metric.h"
+#include "profiler.h"
 #include "Eigen/Eigen"
 
 #include <tuple>
@@ -46,6 +47,27 @@ namespace metric {
     return confusion;
   }
 
+  Eigen::MatrixXd cal_confusion_matrix(const Dataset &data, const Eigen::VectorXd &pred_Y)
+  {
+    int TP{}, FP{}, FN{}, TN{};
+
+    for (int i = 0; i < data.rows(); ++i) {
+      const double y = data.label(i);
+      if (y == 0 && pred_Y(i) == 0)
+        ++TN;
+      else if (y == 0 && pred_Y(i) == 1)
+        ++FP;
+      else if (y == 1 && pred_Y(i) == 1)
+        ++TP;
+      else if (y == 1 && pred_Y(i) == 0)
+        ++FN;
+    }
+
+    Eigen::MatrixXd confusion(2, 2);
+    confusion << TP, FP, FN, TN;
+    return confusion;
+  }
+
   /**
    * @brief Transforming the matrix from [theta, r] data to [x, y] data.
    *
@@ -54,6 +76,7 @@ namespace metric {
    */
   void rtheta_to_xy(Eigen::MatrixXd &data, const int ROWS)
   {
+    ScopedProfile profile(ProfileStage::rtheta_to_xy);
     for (int i = 0; i < ROWS; i++) {
       const double theta = M_PI * data(i, 0) / 180;    // transform the radian to angle
       const double r = data(i, 1);    // radius
@@ -72,6 +95,7 @@ namespace metric {
    */
   std::vector<Eigen::MatrixXd> section_to_segment(const Eigen::MatrixXd &section)    // section is 720*2
   {
+    ScopedProfile profile(ProfileStage::section_to_segment);
     const int ROWS = section.rows();
     const auto &x = section.col(0);
     const auto &y = section.col(1);
@@ -84,6 +108,9 @@ namespace metric {
         valid_index.emplace_back(i);
     }
     int validsize = valid_index.size();    // the number of valid point in the section.
+    if (validsize == 0)
+      return seg_vec;    // all the returns are NaN or zero
+
     bool first_end = std::sqrt(std::pow(x(valid_index[0]) - x(valid_index[validsize - 1]), 2) + std::pow(y(valid_index[0]) - y(valid_index[validsize - 1]), 2)) < threshold;
 
     std::vector<int> single_seg;    // The valid xy point index list of one segment.
@@ -118,7 +145,7 @@ namespace metric {
 
     seg_vec.push_back(std::move(tmp_seg));    // push the matrix into the segment list, which represents the xy data of a segment
 
-    if (first_end) {
+    if (first_end && seg_vec.size() > 1) {    // a closed single segment has nothing to join
       Eigen::MatrixXd &first = seg_vec[0];
       Eigen::MatrixXd &end = seg_vec[seg_vec.size() - 1];
 
@@ -9,6 +9,7 @@
  * @date 2022-11-18
  */
 
+#include "dataset.h"
 #include "Eigen/Eigen"
 
 #include <tuple>
@@ -24,6 +25,15 @@ namespace metric {
    */
   Eigen::MatrixXd cal_confusion_matrix(const Eigen::VectorXd &y, const Eigen::VectorXd &pred_Y);
 
+  /**
+   * @brief Calculate the confusion table of the rows of the view, the labels are read from the storage of the view.
+   *
+   * @param data The rows of the data, with the labels.
+   * @param pred_Y The predicted output of the rows.
+   * @return Eigen::MatrixXd The confusion table.
+   */
+  Eigen::MatrixXd cal_confusion_matrix(const Dataset &data, const Eigen::VectorXd &pred_Y);
+
   /**
    * @brief Transforming the matrix from [theta, r] data to [x, y] data.
    *
@@ -0,0 +1,104 @@
+/**
+ * @file npy_writer.cpp
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The implementation of the NumPy .npy file writer.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "npy_writer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+/**
+ * @brief Open a temporary file for the array, it replaces the .npy file when it's closed.
+ *
+ * @param npy_path The .npy file.
+ * @param descr The numpy dtype string, e.g. "<f8" for double, "<i4" for int, "<i8" for int64.
+ * @param column_num The numbers of the columns, 0 for the 1-D array.
+ * @return true if the file is opened, otherwise false.
+ */
+bool NpyWriter::open(const std::string &npy_path, const std::string &descr, const int column_num)
+{
+  _npy_path = npy_path;
+  _tmp_npy_path = npy_path + ".tmp";
+  _descr = descr;
+  _column_num = column_num;
+  _row_bytes = std::stoi(descr.substr(2)) * std::max(column_num, 1);
+  _row_num = 0;
+
+  _buffer.resize(BUFFER_SIZE);
+  _npy_file.rdbuf()->pubsetbuf(_buffer.data(), _buffer.size());
+  _npy_file.open(_tmp_npy_path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (_npy_file.fail()) {
+    std::cerr << "cant open " << _tmp_npy_path << '\n';
+    return false;
+  }
+
+  _write_header();    // the shape is written again when the file is closed
+  return true;
+}
+
+/**
+ * @brief Append the rows to the array.
+ *
+ * @param data The rows, stored row by row.
+ * @param row_num The numbers of the rows.
+ */
+void NpyWriter::write(const void *data, const std::int64_t row_num)
+{
+  _npy_file.write(reinterpret_cast<const char *>(data), row_num * _row_bytes);
+  _row_num += row_num;
+}
+
+/**
+ * @brief Close the file.
+ *
+ * @param keep Fill the shape then replace the .npy file, otherwise the temporary file is removed.
+ */
+void NpyWriter::close(const bool keep)
+{
+  if (!_npy_file.is_open())
+    return;
+
+  if (keep)
+    _write_header();
+  _npy_file.close();
+
+  if (keep)
+    std::filesystem::rename(_tmp_npy_path, _npy_path);
+  else
+    std::filesystem::remove(_tmp_npy_path);
+}
+
+/**
+ * @brief Write the fixed-size header at the beginning of the file, the dict is padded with spaces and ends with '\n'.
+ */
+void NpyWriter::_write_header()
+{
+  std::string dict = "{'descr': '" + _descr + "', 'fortran_order': False, 'shape': (" + std::to_string(_row_num) +
+                     (_column_num == 0 ? std::string(",") : ", " + std::to_string(_column_num)) + "), }";
+  dict.resize(HEADER_SIZE - 10 - 1, ' ');
+  dict += '\n';
+
+  char header[HEADER_SIZE];
+  const std::uint16_t header_len = HEADER_SIZE - 10;
+  std::memcpy(header, "\x93NUMPY\x01\x00", 8);
+  header[8] = static_cast<char>(header_len & 0xFF);
+  header[9] = static_cast<char>(header_len >> 8);
+  std::memcpy(header + 10, dict.data(), dict.size());
+
+  const std::streampos end = _npy_file.tellp();
+  _npy_file.seekp(0, std::ios::beg);
+  _npy_file.write(header, HEADER_SIZE);
+  if (end > HEADER_SIZE)
+    _npy_file.seekp(end);
+}
+
+NpyWriter::~NpyWriter()
+{
+  close(false);
+}
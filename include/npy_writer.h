@@ -0,0 +1,51 @@
+#ifndef NPY_WRITER_H__
+#define NPY_WRITER_H__
+
+/**
+ * @file npy_writer.h
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The writer of the NumPy .npy file (format version 1.0). The rows are appended as raw little-endian bytes,
+ *        and the shape in the header is filled when the file is closed, thus the rows number needn't be known in advance.
+ *        The data starts at a 64-byte aligned offset, so the file can be loaded by `numpy.load(path, mmap_mode='r')`.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class NpyWriter {
+public:
+  bool open(const std::string &npy_path, const std::string &descr, const int column_num);
+  void write(const void *data, const std::int64_t row_num);
+  void close(const bool keep);
+
+  std::int64_t row_num() const { return _row_num; }
+
+  NpyWriter() = default;
+  NpyWriter(const NpyWriter &) = delete;
+  NpyWriter &operator=(const NpyWriter &) = delete;
+  ~NpyWriter();
+
+public:
+  static constexpr int HEADER_SIZE = 128;    // the bytes of the magic, the version, the header length and the padded header dict
+  static constexpr std::size_t BUFFER_SIZE = 1 << 20;    // the bytes of the stream buffer, the rows are written in large blocks
+
+private:
+  void _write_header();
+
+private:
+  std::string _npy_path;
+  std::string _tmp_npy_path;
+  std::string _descr;
+  int _column_num = 0;    // 0 means the array is 1-D
+  int _row_bytes = 0;
+  std::int64_t _row_num = 0;
+
+  std::vector<char> _buffer;
+  std::ofstream _npy_file;
+};
+
+#endif
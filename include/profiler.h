@@ -0,0 +1,224 @@
+#ifndef PROFILER_H__
+#define PROFILER_H__
+
+/**
+ * @file profiler.h
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The scoped timers of the pipeline stages. Each thread pushes its samples into its own lock-free ring,
+ *        and the GUI thread collects them into the rolling history of each stage once per frame.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "spsc_queue.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief The stages of the pipeline, the time of a stage includes the stages called inside it.
+ */
+enum class ProfileStage : std::uint8_t {
+  read_frame,
+  rtheta_to_xy,
+  section_to_segment,
+  segment_to_feature,
+  normalize,
+  predict,
+  plot,
+  label_save,
+  stage_num
+};
+
+inline constexpr int PROFILE_STAGE_NUM = static_cast<int>(ProfileStage::stage_num);
+inline constexpr const char *PROFILE_STAGE_NAME[PROFILE_STAGE_NUM] = { "read_frame", "rtheta_to_xy", "section_to_segment", "segment_to_feature",
+                                                                       "normalize", "predict", "plot", "label_save" };
+
+struct ProfileSample {
+  ProfileStage stage;
+  float ms;
+};
+
+class Profiler {
+public:
+  static Profiler &instance()
+  {
+    static Profiler profiler;
+    return profiler;
+  }
+
+  /**
+   * @brief Record a sample, it can be called by any thread, the sample is dropped if the ring of the thread is full.
+   */
+  void record(const ProfileStage stage, const float ms)
+  {
+    thread_local RingHandle handle;
+    if (handle.ring == nullptr && !handle.acquired) {
+      handle.ring = _acquire_ring();
+      handle.acquired = true;
+    }
+
+    if (handle.ring != nullptr)
+      handle.ring->queue.push(ProfileSample{ stage, ms });
+  }
+
+  /**
+   * @brief Move the samples in the rings of all threads into the history, only called by the GUI thread.
+   */
+  void collect()
+  {
+    const int ring_num = std::min(_ring_num.load(std::memory_order_acquire), MAX_THREAD_NUM);
+    ProfileSample sample;
+    for (int i = 0; i < ring_num; ++i) {
+      ThreadRing *ring = _ring_arr[i].load(std::memory_order_acquire);
+      while (ring != nullptr && ring->queue.pop(sample))
+        _history_arr[static_cast<int>(sample.stage)].push(sample.ms);
+    }
+
+    for (StageHistory &history : _history_arr)
+      history.update_percentile();
+  }
+
+  /**
+   * @brief The rolling history of the stage, the oldest sample is at `offset`, for `ImPlot::PlotLine` with the offset.
+   */
+  const float *history(const ProfileStage stage) const { return _history_arr[static_cast<int>(stage)].ms_vec.data(); }
+  int history_size(const ProfileStage stage) const { return static_cast<int>(_history_arr[static_cast<int>(stage)].ms_vec.size()); }
+  int history_offset(const ProfileStage stage) const { return _history_arr[static_cast<int>(stage)].next; }
+
+  float last(const ProfileStage stage) const { return _history_arr[static_cast<int>(stage)].last; }
+  float p50(const ProfileStage stage) const { return _history_arr[static_cast<int>(stage)].p50; }
+  float p99(const ProfileStage stage) const { return _history_arr[static_cast<int>(stage)].p99; }
+  std::uint64_t count(const ProfileStage stage) const { return _history_arr[static_cast<int>(stage)].count; }
+
+  Profiler(const Profiler &) = delete;
+  Profiler &operator=(const Profiler &) = delete;
+
+public:
+  static constexpr int MAX_THREAD_NUM = 64;
+  static constexpr int RING_SIZE = 1024;    // the samples of a thread between two collections
+  static constexpr int HISTORY_SIZE = 512;    // the samples kept for each stage
+
+  std::atomic<bool> enabled = false;    // enabled by the GUI, which collects the samples every frame, the headless tools don't record
+
+private:
+  Profiler() = default;
+
+  struct ThreadRing {
+    SpscQueue<ProfileSample> queue{ RING_SIZE };
+    std::atomic<bool> in_use = false;
+  };
+
+  /**
+   * @brief Release the ring when the thread exits, thus the thread created later can reuse it.
+   */
+  struct RingHandle {
+    ThreadRing *ring = nullptr;
+    bool acquired = false;
+
+    ~RingHandle()
+    {
+      if (ring != nullptr)
+        ring->in_use.store(false, std::memory_order_release);
+    }
+  };
+
+  struct StageHistory {
+    std::vector<float> ms_vec;    // the ring of the latest samples
+    int next = 0;    // the position of the next sample, which is also the oldest one when the ring is full
+    std::uint64_t count = 0;
+    bool changed = false;
+
+    float last = 0, p50 = 0, p99 = 0;
+    std::vector<float> sort_buf;
+
+    void push(const float ms)
+    {
+      if (static_cast<int>(ms_vec.size()) < HISTORY_SIZE)
+        ms_vec.push_back(ms);
+      else
+        ms_vec[next] = ms;
+
+      next = (next + 1) % HISTORY_SIZE;
+      last = ms;
+      ++count;
+      changed = true;
+    }
+
+    void update_percentile()
+    {
+      if (!changed)
+        return;
+
+      changed = false;
+      sort_buf = ms_vec;
+      std::nth_element(sort_buf.begin(), sort_buf.begin() + sort_buf.size() / 2, sort_buf.end());
+      p50 = sort_buf[sort_buf.size() / 2];
+      std::nth_element(sort_buf.begin(), sort_buf.begin() + sort_buf.size() * 99 / 100, sort_buf.end());
+      p99 = sort_buf[sort_buf.size() * 99 / 100];
+    }
+  };
+
+  /**
+   * @brief Take a ring released by an exited thread, or create a new one.
+   *
+   * @return ThreadRing* The ring, nullptr if there are too many threads.
+   */
+  ThreadRing *_acquire_ring()
+  {
+    const int ring_num = std::min(_ring_num.load(std::memory_order_acquire), MAX_THREAD_NUM);
+    for (int i = 0; i < ring_num; ++i) {
+      ThreadRing *ring = _ring_arr[i].load(std::memory_order_acquire);
+      bool in_use = false;
+      if (ring != nullptr && ring->in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire))
+        return ring;
+    }
+
+    const int index = _ring_num.fetch_add(1, std::memory_order_acq_rel);
+    if (index >= MAX_THREAD_NUM)
+      return nullptr;
+
+    ThreadRing *ring = new ThreadRing;    // never deleted, the rings live as long as the program
+    ring->in_use = true;
+    _ring_arr[index].store(ring, std::memory_order_release);
+    return ring;
+  }
+
+private:
+  std::array<std::atomic<ThreadRing *>, MAX_THREAD_NUM> _ring_arr = {};
+  std::atomic<int> _ring_num = 0;
+  std::array<StageHistory, PROFILE_STAGE_NUM> _history_arr;
+};
+
+/**
+ * @brief Time the scope as a sample of the stage.
+ */
+class ScopedProfile {
+public:
+  explicit ScopedProfile(const ProfileStage stage)
+      : _stage(stage), _enabled(Profiler::instance().enabled.load(std::memory_order_relaxed))
+  {
+    if (_enabled)
+      _start = std::chrono::steady_clock::now();
+  }
+
+  ~ScopedProfile()
+  {
+    if (_enabled)
+      Profiler::instance().record(_stage, std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - _start).count());
+  }
+
+  ScopedProfile(const ScopedProfile &) = delete;
+  ScopedProfile &operator=(const ScopedProfile &) = delete;
+
+private:
+  ProfileStage _stage;
+  bool _enabled;
+  std::chrono::steady_clock::time_point _start;
+};
+
+#endif
@@ -0,0 +1,195 @@
+/**
+ * @file scan_generator.cpp
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The implementation of the synthetic laser scan generator.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "scan_generator.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+#if _WIN32
+#define _USE_MATH_DEFINES
+#include <math.h>
+#endif
+
+namespace {
+  constexpr double SCALE = 1e5;    // 10^DECIMAL_NUM
+
+  double round_decimal(const double value) { return std::round(value * SCALE) / SCALE; }
+}    // namespace
+
+/**
+ * @brief The scene is checked by the caller, an invalid one throws `std::invalid_argument`.
+ */
+ScanGenerator::ScanGenerator(const ScanScene &scene)
+    : _scene(scene)
+{
+  if (_scene.rtheta && _scene.HZ != 360 && _scene.HZ != 720)
+    throw std::invalid_argument("the [theta r] log needs a 1 or 0.5 degree step, thus the HZ must be 360 or 720, but it's " + std::to_string(_scene.HZ));
+
+  // the room decides where the objects are, the default size is used if there are no walls
+  const double half_x = _scene.room_half_x > 0 ? _scene.room_half_x : 4;
+  const double half_y = _scene.room_half_y > 0 ? _scene.room_half_y : 3;
+
+  std::mt19937_64 gen(_scene.seed);
+  std::uniform_real_distribution<double> unit(0, 1);
+
+  for (int b = 0; b < _scene.ball_num; ++b) {
+    Ball ball;
+    ball.amplitude_x = half_x * (0.15 + 0.7 * unit(gen));
+    ball.amplitude_y = half_y * (0.15 + 0.7 * unit(gen));
+    ball.speed = 0.005 + 0.025 * unit(gen);    // radian per frame
+    ball.phase = 2 * M_PI * unit(gen);
+    _ball_vec.push_back(ball);
+  }
+
+  for (int c = 0; c < _scene.clutter_num; ++c) {
+    const double side = 0.1 + 0.4 * unit(gen);
+    double center_x, center_y;
+    do {
+      center_x = (2 * unit(gen) - 1) * half_x * 0.85;
+      center_y = (2 * unit(gen) - 1) * half_y * 0.85;
+    } while (std::hypot(center_x, center_y) < side + 0.5);    // keep the sensor out of the box
+
+    _box_vec.push_back(Box{ center_x - side / 2, center_x + side / 2, center_y - side / 2, center_y + side / 2 });
+  }
+}
+
+/**
+ * @brief The center of the ball in the frame, the balls move on the ellipses around the sensor.
+ */
+Eigen::Vector2d ScanGenerator::ball_center(const int frame_i, const int ball_i) const
+{
+  const Ball &ball = _ball_vec[ball_i];
+  const double angle = ball.phase + ball.speed * frame_i;
+  return Eigen::Vector2d(ball.amplitude_x * std::cos(angle), ball.amplitude_y * std::sin(angle));
+}
+
+/**
+ * @brief Check if the point is on a ball of the frame, with the tolerance of the range noise.
+ */
+bool ScanGenerator::on_ball(const int frame_i, const double x, const double y) const
+{
+  const double tolerance = _scene.ball_radius + 4 * _scene.noise + 0.01;
+  for (int b = 0; b < _scene.ball_num; ++b) {
+    const Eigen::Vector2d center = ball_center(frame_i, b);
+    if (std::hypot(x - center(0), y - center(1)) <= tolerance)
+      return true;
+  }
+
+  return false;
+}
+
+/**
+ * @brief Make a frame as it's written in the log.
+ *
+ * @param frame_i The frame.
+ * @param raw_data The HZ*2 [theta r] or [x y] data, rounded to the decimals of the log.
+ * @param point_label The label of each point, 1 if the ray hits a ball, otherwise 0.
+ */
+void ScanGenerator::make_frame(const int frame_i, Eigen::MatrixXd &raw_data, std::vector<std::uint8_t> &point_label) const
+{
+  const int HZ = _scene.HZ;
+  raw_data.resize(HZ, 2);
+  point_label.assign(HZ, 0);
+
+  // the random numbers of a frame only depend on the seed and the frame
+  std::seed_seq seq{ static_cast<std::uint32_t>(_scene.seed), static_cast<std::uint32_t>(_scene.seed >> 32), static_cast<std::uint32_t>(frame_i) };
+  std::mt19937_64 gen(seq);
+  std::normal_distribution<double> noise(0, _scene.noise);
+  std::uniform_real_distribution<double> unit(0, 1);
+
+  std::vector<Eigen::Vector2d> center_vec(_scene.ball_num);
+  for (int b = 0; b < _scene.ball_num; ++b)
+    center_vec[b] = ball_center(frame_i, b);
+
+  const double inf = std::numeric_limits<double>::infinity();
+  for (int i = 0; i < HZ; ++i) {
+    const double theta = 360.0 * i / HZ;
+    const double dx = std::cos(M_PI * theta / 180), dy = std::sin(M_PI * theta / 180);
+
+    double t = inf;
+    bool hit_ball = false;
+
+    // the walls
+    if (_scene.room_half_x > 0 && _scene.room_half_y > 0) {
+      if (std::abs(dx) > 1e-12)
+        t = std::min(t, _scene.room_half_x / std::abs(dx));
+      if (std::abs(dy) > 1e-12)
+        t = std::min(t, _scene.room_half_y / std::abs(dy));
+    }
+
+    // the boxes, by the slabs of the two axes
+    for (const Box &box : _box_vec) {
+      double t_near = -inf, t_far = inf;
+      bool miss = false;
+      for (const auto &[d, min, max] : { std::tuple{ dx, box.min_x, box.max_x }, std::tuple{ dy, box.min_y, box.max_y } }) {
+        if (std::abs(d) < 1e-12) {
+          miss |= (min > 0 || max < 0);    // parallel to the slab, and the origin isn't in it
+          continue;
+        }
+
+        const double t1 = min / d, t2 = max / d;
+        t_near = std::max(t_near, std::min(t1, t2));
+        t_far = std::min(t_far, std::max(t1, t2));
+      }
+
+      if (!miss && t_near > 0 && t_near <= t_far && t_near < t)
+        t = t_near;
+    }
+
+    // the balls
+    for (const Eigen::Vector2d &center : center_vec) {
+      const double proj = dx * center(0) + dy * center(1);
+      const double disc = proj * proj - (center.squaredNorm() - _scene.ball_radius * _scene.ball_radius);
+      if (disc > 0 && proj - std::sqrt(disc) > 0 && proj - std::sqrt(disc) < t) {
+        t = proj - std::sqrt(disc);
+        hit_ball = true;
+      }
+    }
+
+    // the noise is always drawn, thus the dropouts don't change the noise of the later points
+    const double range_noise = noise(gen);
+    double r = (t == inf) ? 0 : t + range_noise;
+    const double dropout = unit(gen);
+    if (dropout < _scene.nan_rate)
+      r = std::numeric_limits<double>::quiet_NaN();
+    else if (dropout < _scene.nan_rate + _scene.zero_rate)
+      r = 0;
+
+    point_label[i] = (hit_ball && r > 0) ? 1 : 0;    // a NaN is not greater than 0
+    if (_scene.rtheta) {
+      raw_data(i, 0) = theta;
+      raw_data(i, 1) = round_decimal(r);
+    }
+    else {
+      raw_data(i, 0) = round_decimal(r * dx);
+      raw_data(i, 1) = round_decimal(r * dy);
+    }
+  }
+}
+
+/**
+ * @brief Append the frame to the text of the log, a "a b" line per point.
+ */
+void ScanGenerator::append_raw_text(const Eigen::MatrixXd &raw_data, std::string &text)
+{
+  char buf[64];
+  for (int i = 0; i < raw_data.rows(); ++i) {
+    char *p = std::to_chars(buf, buf + 31, raw_data(i, 0), std::chars_format::fixed, DECIMAL_NUM).ptr;
+    *p++ = ' ';
+    p = std::to_chars(p, buf + 63, raw_data(i, 1), std::chars_format::fixed, DECIMAL_NUM).ptr;
+    *p++ = '\n';
+    text.append(buf, p);
+  }
+}
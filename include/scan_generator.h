@@ -0,0 +1,63 @@
+#ifndef SCAN_GENERATOR_H__
+#define SCAN_GENERATOR_H__
+
+/**
+ * @file scan_generator.h
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The generator of the synthetic laser scans. A scan is the rays from the origin hitting a rectangle room,
+ *        some moving balls (the target) and some static boxes (the clutter), with the range noise, the NaN returns and the zero returns.
+ *        A frame depends only on the scene and its index, thus the frames can be generated by any thread in any order.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "Eigen/Eigen"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ScanScene {
+  int HZ = 360;    // the points of a frame
+  bool rtheta = false;    // the log is [theta r] (the theta step is 360/HZ degrees, which must be 0.5 or 1), otherwise [x y]
+  double room_half_x = 3, room_half_y = 2;    // the walls, no walls if it's not positive, then the rays hitting nothing are zero returns
+  int ball_num = 3;
+  double ball_radius = 0.1;
+  int clutter_num = 4;    // the static boxes
+  double noise = 0.005;    // the standard deviation of the range noise
+  double nan_rate = 0;    // the probability of a NaN return
+  double zero_rate = 0;    // the probability of a zero return
+  std::uint64_t seed = 1;
+};
+
+class ScanGenerator {
+public:
+  void make_frame(const int frame_i, Eigen::MatrixXd &raw_data, std::vector<std::uint8_t> &point_label) const;
+  Eigen::Vector2d ball_center(const int frame_i, const int ball_i) const;
+  bool on_ball(const int frame_i, const double x, const double y) const;
+
+  const ScanScene &scene() const { return _scene; }
+
+  static void append_raw_text(const Eigen::MatrixXd &raw_data, std::string &text);
+
+  explicit ScanGenerator(const ScanScene &scene);
+
+public:
+  static constexpr int DECIMAL_NUM = 5;    // the decimals of the numbers in the log
+
+private:
+  struct Ball {
+    double amplitude_x, amplitude_y;
+    double speed, phase;
+  };
+
+  struct Box {
+    double min_x, max_x, min_y, max_y;
+  };
+
+  ScanScene _scene;
+  std::vector<Ball> _ball_vec;
+  std::vector<Box> _box_vec;
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef SPSC_QUEUE_H__
+#define SPSC_QUEUE_H__
+
+/**
+ * @file spsc_queue.h
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The lock-free single-producer single-consumer ring buffer.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief The lock-free queue for exactly one producer thread and one consumer thread.
+ *
+ * @tparam T The type of the element, it must be default constructible and movable.
+ */
+template <typename T>
+class SpscQueue {
+public:
+  /**
+   * @param capacity The maximum numbers of the elements, it would be rounded up to a power of 2.
+   */
+  explicit SpscQueue(const std::size_t capacity)
+  {
+    std::size_t size = 1;
+    while (size < capacity)
+      size <<= 1;
+
+    _buffer.resize(size);
+    _mask = size - 1;
+  }
+
+  /**
+   * @brief Push the element, only called by the producer.
+   *
+   * @return true if it's pushed, false if the queue is full (the element is not moved).
+   */
+  bool push(T &&value)
+  {
+    const std::size_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail - _head.load(std::memory_order_acquire) == _buffer.size())
+      return false;
+
+    _buffer[tail & _mask] = std::move(value);
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Pop the element, only called by the consumer.
+   *
+   * @return true if it's popped, false if the queue is empty.
+   */
+  bool pop(T &value)
+  {
+    const std::size_t head = _head.load(std::memory_order_relaxed);
+    if (head == _tail.load(std::memory_order_acquire))
+      return false;
+
+    value = std::move(_buffer[head & _mask]);
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief The numbers of the elements in the queue, it may be out of date when it returns.
+   */
+  std::size_t size() const { return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire); }
+
+private:
+  std::vector<T> _buffer;
+  std::size_t _mask;
+
+  alignas(64) std::atomic<std::size_t> _head = 0;    // the next element would be popped, written by the consumer
+  alignas(64) std::atomic<std::size_t> _tail = 0;    // the next slot would be pushed, written by the producer
+};
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ * @file task_scheduler.cpp
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The implementation of the shared thread pool.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "task_scheduler.h"
+
+#include <chrono>
+#include <thread>
+
+namespace {
+  std::atomic<int> requested_thread_num = 0;
+}    // namespace
+
+/**
+ * @brief The pool is created at the first call, it has all the cores but at least 2 threads,
+ *        thus a long background job (an export, a compaction) doesn't block the other tasks on a single core machine.
+ *        It's never destroyed, thus the destructors of the static objects can still wait for their tasks.
+ */
+TaskScheduler &TaskScheduler::instance()
+{
+  static TaskScheduler *scheduler = new TaskScheduler(requested_thread_num > 0 ? requested_thread_num.load()
+                                                                               : std::max(2, static_cast<int>(std::thread::hardware_concurrency())));
+  return *scheduler;
+}
+
+/**
+ * @brief Set the threads of the pool, it only works before the first call of `instance()`.
+ */
+void TaskScheduler::set_thread_num(const int thread_num)
+{
+  requested_thread_num = std::max(1, thread_num);
+}
+
+TaskScheduler::TaskScheduler(const int thread_num)
+    : _pool(thread_num, false)    // no spinning, the GUI shares the cores with the pool
+{
+}
+
+/**
+ * @brief Run the task in the pool, the task must not throw, use `submit` or `TaskGroup` if it may throw.
+ *        If the queue of the worker is full, the task runs in the calling thread.
+ */
+void TaskScheduler::schedule(std::function<void()> task)
+{
+  ++_queue_depth;
+  _pool.Schedule([this, task = std::move(task)] {
+    --_queue_depth;
+    ++_active_num;
+    const auto start = std::chrono::steady_clock::now();
+
+    task();
+
+    _busy_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    --_active_num;
+  });
+}
+
+TaskSchedulerStats TaskScheduler::stats() const
+{
+  return TaskSchedulerStats{ thread_num(), _queue_depth.load(), _active_num.load(), _busy_ns.load() * 1e-9 };
+}
+
+/**
+ * @brief Pop a task and run it, the task is skipped if the group is canceled.
+ *
+ * @return false if there is no task to run.
+ */
+bool TaskGroup::State::run_one()
+{
+  std::function<void()> task;
+  {
+    std::lock_guard lock(mutex);
+    if (task_queue.empty())
+      return false;
+
+    task = std::move(task_queue.front());
+    task_queue.pop_front();
+  }
+
+  if (!canceled) {
+    try {
+      task();
+    }
+    catch (...) {
+      std::lock_guard lock(mutex);
+      if (!exception)
+        exception = std::current_exception();
+    }
+  }
+
+  std::lock_guard lock(mutex);
+  if (--unfinished_num == 0)
+    done_cv.notify_all();
+
+  return true;
+}
+
+TaskGroup::TaskGroup(TaskScheduler &scheduler)
+    : _scheduler(scheduler), _state(std::make_shared<State>())
+{
+}
+
+/**
+ * @brief Wait for all the tasks, then rethrow the first exception thrown by them.
+ */
+void TaskGroup::wait()
+{
+  while (_state->run_one())
+    ;
+
+  std::unique_lock lock(_state->mutex);
+  _state->done_cv.wait(lock, [this] { return _state->unfinished_num == 0; });
+
+  if (_state->exception) {
+    std::exception_ptr exception = _state->exception;
+    _state->exception = nullptr;
+    std::rethrow_exception(exception);
+  }
+}
+
+TaskGroup::~TaskGroup()
+{
+  try {
+    wait();
+  }
+  catch (...) {
+  }
+}
@@ -0,0 +1,176 @@
+#ifndef TASK_SCHEDULER_H__
+#define TASK_SCHEDULER_H__
+
+/**
+ * @file task_scheduler.h
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The thread pool shared by the whole project, it's the work-stealing pool of the bundled Eigen (`Eigen::ThreadPool`).
+ *        The batch jobs and the background jobs of the GUI run their tasks on it instead of creating their own threads.
+ *        The thread waiting for a `parallel_for` or a `TaskGroup` runs the tasks which are not started yet by itself,
+ *        thus they can be nested in the tasks, but a task should not block on a future of another task.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#include "unsupported/Eigen/CXX11/ThreadPool"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+struct TaskSchedulerStats {
+  int thread_num;
+  int queue_depth;    // the tasks scheduled but not started
+  int active_num;    // the tasks running
+  double busy_seconds;    // the total running time of the tasks since the pool was created
+};
+
+class TaskScheduler {
+public:
+  static TaskScheduler &instance();
+  static void set_thread_num(const int thread_num);
+
+  void schedule(std::function<void()> task);
+
+  /**
+   * @brief Run the function in the pool.
+   *
+   * @return std::future The result, or the exception thrown by the function.
+   */
+  template <typename Function>
+  auto submit(Function &&function) -> std::future<std::invoke_result_t<std::decay_t<Function>>>
+  {
+    using Result = std::invoke_result_t<std::decay_t<Function>>;
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+    std::future<Result> future = task->get_future();
+    schedule([task] { (*task)(); });
+    return future;
+  }
+
+  template <typename Function>
+  bool parallel_for(const int begin, const int end, const int grain, Function &&body, const std::atomic<bool> *cancel = nullptr);
+
+  int thread_num() const { return _pool.NumThreads(); }
+  bool in_worker() const { return _pool.CurrentThreadId() >= 0; }
+  TaskSchedulerStats stats() const;
+
+  TaskScheduler(const TaskScheduler &) = delete;
+  TaskScheduler &operator=(const TaskScheduler &) = delete;
+
+private:
+  explicit TaskScheduler(const int thread_num);
+
+private:
+  Eigen::ThreadPool _pool;
+  std::atomic<int> _queue_depth = 0;
+  std::atomic<int> _active_num = 0;
+  std::atomic<std::int64_t> _busy_ns = 0;
+};
+
+/**
+ * @brief Call `body(chunk_begin, chunk_end)` for each chunk of [begin, end) in parallel, the calling thread also takes the chunks.
+ *        At most `thread_num()` chunks run at once, the body must not throw.
+ *
+ * @param begin The begin of the range.
+ * @param end The end of the range.
+ * @param grain The size of a chunk.
+ * @param body The function called for each chunk.
+ * @param cancel The chunks not started are skipped if it's set.
+ * @return true if all the chunks are done, false if it's canceled.
+ */
+template <typename Function>
+bool TaskScheduler::parallel_for(const int begin, const int end, const int grain, Function &&body, const std::atomic<bool> *cancel)
+{
+  if (begin >= end)
+    return true;
+
+  const int step = std::max(1, grain);
+  const int chunk_num = (end - begin + step - 1) / step;
+
+  struct State {
+    std::atomic<int> next_chunk = 0;
+    std::atomic<int> done_chunk = 0;
+    std::mutex mutex;
+    std::condition_variable done_cv;
+  };
+
+  // the helpers may start after all the chunks are taken, then they only touch the state, which is kept alive by them
+  auto state = std::make_shared<State>();
+  auto *body_ptr = &body;
+  auto work = [state, chunk_num, begin, end, step, cancel, body_ptr] {
+    for (int chunk = state->next_chunk++; chunk < chunk_num; chunk = state->next_chunk++) {
+      if (cancel == nullptr || !cancel->load(std::memory_order_relaxed)) {
+        const int chunk_begin = begin + chunk * step;
+        (*body_ptr)(chunk_begin, std::min(end, chunk_begin + step));
+      }
+
+      if (state->done_chunk.fetch_add(1) + 1 == chunk_num) {
+        std::lock_guard lock(state->mutex);
+        state->done_cv.notify_all();
+      }
+    }
+  };
+
+  const int helper_num = std::min(thread_num() - 1, chunk_num - 1);
+  for (int i = 0; i < helper_num; ++i)
+    schedule(work);
+
+  work();
+
+  std::unique_lock lock(state->mutex);
+  state->done_cv.wait(lock, [&] { return state->done_chunk.load() == chunk_num; });
+  return cancel == nullptr || !cancel->load();
+}
+
+/**
+ * @brief A group of the tasks which can be waited and canceled together.
+ *        `wait` runs the tasks not started yet in the calling thread, then waits for the running ones.
+ */
+class TaskGroup {
+public:
+  template <typename Function>
+  void run(Function &&function)
+  {
+    {
+      std::lock_guard lock(_state->mutex);
+      _state->task_queue.emplace_back(std::forward<Function>(function));
+      ++_state->unfinished_num;
+    }
+
+    _scheduler.schedule([state = _state] { state->run_one(); });
+  }
+
+  void wait();
+  void cancel() { _state->canceled = true; }
+  bool canceled() const { return _state->canceled; }
+
+  explicit TaskGroup(TaskScheduler &scheduler = TaskScheduler::instance());
+  TaskGroup(const TaskGroup &) = delete;
+  TaskGroup &operator=(const TaskGroup &) = delete;
+  ~TaskGroup();
+
+private:
+  struct State {
+    std::mutex mutex;
+    std::condition_variable done_cv;
+    std::deque<std::function<void()>> task_queue;    // the tasks not started
+    int unfinished_num = 0;
+    std::atomic<bool> canceled = false;
+    std::exception_ptr exception;    // the first exception thrown by the tasks
+
+    bool run_one();
+  };
+
+  TaskScheduler &_scheduler;
+  std::shared_ptr<State> _state;
+};
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef TRACE_H__
+#define TRACE_H__
+
+/**
+ * @file trace.h
+ * @author Mes (mes900903@gmail.com) (Discord: Mes#0903)
+ * @brief The scoped tracing of the batch tools, it's compiled only if MRL_ENABLE_TRACE is defined, otherwise the scopes are nothing.
+ *        Each thread records the scopes into its own buffer, and the buffers are written into a chrome://tracing (or Perfetto) JSON file at exit,
+ *        the file is $MRL_TRACE_FILE, or mrl_trace.json in the working directory.
+ *        The buffers are read without locking at exit, thus the scopes must not run after main returns, i.e. main waits for the tasks
+ *        of the TaskScheduler recording the scopes (its threads are never joined), and the static objects don't record scopes in their destructors.
+ * @version 0.1
+ * @date 2026-10-18
+ */
+
+#ifdef MRL_ENABLE_TRACE
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief A complete event of the trace, the name must be a string literal.
+ */
+struct TraceEvent {
+  const char *name;
+  double ts;    // the start time in microseconds since the tracer was created
+  double dur;    // the duration in microseconds
+};
+
+class Tracer {
+public:
+  static Tracer &instance()
+  {
+    static Tracer tracer;
+    return tracer;
+  }
+
+  /**
+   * @brief The buffer of the calling thread, it's created when the thread records the first event.
+   */
+  std::vector<TraceEvent> &thread_buffer()
+  {
+    thread_local ThreadBuffer *buffer = _register_thread();
+    return buffer->event_vec;
+  }
+
+  double now() const { return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - _start).count(); }
+
+  /**
+   * @brief Write the events of all threads into the trace file, the threads must have finished recording.
+   *        It's called by the destructor at exit, after main returned.
+   */
+  void dump()
+  {
+    std::lock_guard lock(_mutex);
+
+    const char *env_path = std::getenv("MRL_TRACE_FILE");
+    const char *trace_path = (env_path != nullptr && env_path[0] != '\0') ? env_path : "mrl_trace.json";
+    std::FILE *outfile = std::fopen(trace_path, "w");
+    if (outfile == nullptr) {
+      std::fprintf(stderr, "cant open %s\n", trace_path);
+      return;
+    }
+
+    std::fputs("{\"traceEvents\":[", outfile);
+    bool first = true;
+    for (const auto &buffer : _buffer_vec) {
+      for (const TraceEvent &event : buffer->event_vec) {
+        std::fprintf(outfile, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                     first ? "" : ",", event.name, buffer->tid, event.ts, event.dur);
+        first = false;
+      }
+    }
+    std::fputs("\n],\"displayTimeUnit\":\"ms\"}\n", outfile);
+    std::fclose(outfile);
+  }
+
+  Tracer(const Tracer &) = delete;
+  Tracer &operator=(const Tracer &) = delete;
+  ~Tracer() { dump(); }
+
+private:
+  struct ThreadBuffer {
+    int tid;    // the order of the thread recording its first event, the main thread is usually 1
+    std::vector<TraceEvent> event_vec;
+  };
+
+  Tracer()
+      : _start(std::chrono::steady_clock::now()) {}
+
+  ThreadBuffer *_register_thread()
+  {
+    std::lock_guard lock(_mutex);
+
+    _buffer_vec.push_back(std::make_unique<ThreadBuffer>());
+    _buffer_vec.back()->tid = static_cast<int>(_buffer_vec.size());
+    return _buffer_vec.back().get();
+  }
+
+private:
+  std::chrono::steady_clock::time_point _start;
+  std::mutex _mutex;    // only guard the registration and the dump, the recording doesn't lock
+  std::vector<std::unique_ptr<ThreadBuffer>> _buffer_vec;    // kept after the thread exits, thus the events are written at exit
+};
+
+/**
+ * @brief Record the scope as a complete event.
+ */
+class TraceScope {
+public:
+  explicit TraceScope(const char *name)
+      : _name(name), _start(Tracer::instance().now()) {}
+
+  ~TraceScope()
+  {
+    Tracer &tracer = Tracer::instance();
+    tracer.thread_buffer().push_back(TraceEvent{ _name, _start, tracer.now() - _start });
+  }
+
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+  const char *_name;
+  double _start;
+};
+
+#define MRL_TRACE_CONCAT_IMPL(a, b) a##b
+#define MRL_TRACE_CONCAT(a, b) MRL_TRACE_CONCAT_IMPL(a, b)
+#define MRL_TRACE_SCOPE(name) TraceScope MRL_TRACE_CONCAT(mrl_trace_scope_, __LINE__)(name)
+
+#else
+
+#define MRL_TRACE_SCOPE(name) ((void)0)
+
+#endif
+
+#endif